@@ -5,11 +5,20 @@
  * under certain conditions; type `show c' for details.
  *
  * This file contains an example of the benchmark of the algorithm.
+ * Run it with "hugepages" to compare the tables on normal and huge pages,
+ * or with "profiles" to compare the sets of tables.
  */
 
+#include <string>
 #include <min2phase/tools.h>
 
 int main(int argc, char* argv[]){
-    min2phase::tools::benchmark();
+    if (argc > 1 && std::string(argv[1]) == "hugepages")
+        min2phase::tools::benchmarkHugePages();
+    else if (argc > 1 && std::string(argv[1]) == "profiles")
+        min2phase::tools::benchmarkProfiles();
+    else
+        min2phase::tools::benchmark();
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,17 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the microbenchmarks of the coordinates of the cubie
+ * cube: the rank and unrank of the permutations and the combinations.
+ */
+
+#include <min2phase/tools.h>
+
+int main(){
+    min2phase::tools::benchmarkCoordinates();
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the benchmark of the de-duplication of the cube states:
+ * the hash of a key, the exact set and the bloom filter, with the memory of
+ * both and the false positives of the bloom filter.
+ * Run it with the number of states to insert (default 10000000).
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/dedup.h"
+#include "../include/min2phase/tools.h"
+
+// False positive rate of the bloom filter, the one of the generator
+static const double FALSE_POSITIVE = 0.001;
+
+// Runs the function on every key and returns the nanoseconds per key
+template<typename F>
+static double bench(const std::vector<std::array<uint64_t, 2>>& keys, size_t first, size_t count, F function) {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = first; i < first + count; i++) {
+        function(keys[i].data());
+    }
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 10000000;
+    std::vector<std::array<uint64_t, 2>> keys(2 * count);
+    std::mt19937_64 random(42);
+    StateSet states;
+    BloomFilter bloom(count, FALSE_POSITIVE);
+    uint64_t sum = 0;
+    size_t found = 0, false_positives = 0;
+    double times[5];
+
+    //random keys in the ranges of the coordinates, the second half is never inserted
+    for (std::array<uint64_t, 2>& key : keys) {
+        key[0] = random() % 40320 | random() % 2187 << 16 | random() % 2048 << 28;
+        key[1] = random() % 479001600;
+    }
+
+    times[0] = bench(keys, 0, keys.size(), [&sum](const uint64_t* key) { sum += min2phase::tools::stateHash(key); });
+    times[1] = bench(keys, 0, count, [&states](const uint64_t* key) { states.insert(key); });
+    times[2] = bench(keys, 0, count, [&states, &found](const uint64_t* key) { found += states.contains(key); });
+    times[3] = bench(keys, 0, count, [&bloom](const uint64_t* key) { bloom.insert(key); });
+    times[4] = bench(keys, count, count, [&bloom, &false_positives](const uint64_t* key) {
+        false_positives += bloom.contains(key);
+    });
+
+    if (states.size() != count || found != count || sum == 0) {
+        std::printf("The set does not hold the inserted states.\n");
+        return 1;
+    }
+
+    std::printf("| %zu states | ns/state | bytes/state |\n", count);
+    std::printf("|:---|---:|---:|\n");
+    std::printf("| hash | %.2f | |\n", times[0]);
+    std::printf("| exact, insert | %.2f | %.2f |\n", times[1], (double) states.memory() / count);
+    std::printf("| exact, contains | %.2f | |\n", times[2]);
+    std::printf("| bloom, insert | %.2f | %.2f |\n", times[3], (double) bloom.memory() / count);
+    std::printf("| bloom, contains | %.2f | |\n", times[4]);
+    std::printf("\nBloom filter: %d bits per state, %.4f%% false positives\n", bloom.hashes(),
+                100.0 * false_positives / count);
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the tests of the sticker cubes of the LTCT scrambles:
+ * the turns against the cycles of the faces, the parse of the scrambles, the
+ * packed cube, the precomposed sequences and the batch of cubes against the
+ * sticker cube, and the blindfold traces of known scrambles.
+ */
+
+#include <array>
+#include <cassert>
+#include <random>
+#include <string>
+
+#include "../include/cube.h"
+#include "../include/turns.h"
+#include "../include/packed_cube.h"
+#include "../include/cube_batch.h"
+#include "../include/tracing.h"
+
+// Number of random scrambles of every test
+static constexpr int N_SCRAMBLES = 256;
+
+// Number of turns of a random scramble
+static constexpr int SCRAMBLE_LENGTH = 25;
+
+// Names of the moves, in the order of Turns::Move
+static const char* const MOVE_NAMES[Turns::N_MOVES] = {
+    "U", "U2", "U'", "L", "L2", "L'", "F", "F2", "F'", "R", "R2", "R'", "B", "B2", "B'", "D", "D2", "D'"
+};
+
+// Draws a scramble of random turns
+static std::string random_scramble(std::mt19937& random) {
+    std::uniform_int_distribution<int> move(0, Turns::N_MOVES - 1);
+    std::string scramble;
+
+    for (int i = 0; i < SCRAMBLE_LENGTH; i++) {
+        scramble += std::string(MOVE_NAMES[move(random)]) + " ";
+    }
+
+    return scramble;
+}
+
+// The turns move the stickers of the cycles of their face and undo each other
+static void test_turns() {
+    Cube cube;
+    std::array<unsigned short, 54> state;
+
+    for (int move = 0; move < Turns::N_MOVES; move++) {
+        Turns::turn(cube, move);
+        state = cube.get_state();
+
+        for (const auto& cycle : Turns::CYCLES[move / 3]) {
+            for (int j = 0; j < 4; j++) {
+                assert(state[cycle[j]] == cycle[(j + move % 3 + 1) & 3]);
+            }
+        }
+
+        //a turn and its inverse, a half turn twice
+        Turns::turn(cube, move / 3 * 3 + 2 - move % 3);
+        assert(cube.is_solved());
+    }
+
+    //the sexy move six times is solved
+    for (int i = 0; i < 6; i++) {
+        assert(cube.scramble_cube("R U R' U'"));
+    }
+    assert(cube.is_solved());
+}
+
+// The scrambles are parsed in one pass, a malformed one leaves the cube as it was
+static void test_parse() {
+    unsigned char moves[4];
+    Cube cube("R U");
+    const std::array<unsigned short, 54> state = cube.get_state();
+
+    assert(Turns::parse("  R U2\tF'  ", moves, 4) == 3);
+    assert(moves[0] == Turns::R && moves[1] == Turns::U2 && moves[2] == Turns::F_PRIME);
+    assert(Turns::parse("", moves, 4) == 0);
+
+    //a bad token, a power without a space after it, too many moves
+    assert(Turns::parse("R X", moves, 4) == -1);
+    assert(Turns::parse("R U2'", moves, 4) == -1);
+    assert(Turns::parse("R U R' U' R", moves, 4) == -1);
+
+    assert(cube.scramble_cube("F D'"));
+    assert(cube.get_state() != state);
+    assert(cube.scramble_cube("D F'"));
+    assert(cube.get_state() == state);
+
+    //the turns before the bad token are undone
+    assert(!cube.scramble_cube("R U Q"));
+    assert(cube.get_state() == state);
+    assert(Cube("R U Q").is_solved());
+
+    PackedCube packed("R U");
+    assert(!packed.scramble_cube("F Q") && packed.get_state() == state);
+}
+
+// The packed cube and the precomposed sequences give the states of the sticker cube
+static void test_packed(std::mt19937& random) {
+    std::string first, second;
+
+    for (int i = 0; i < N_SCRAMBLES; i++) {
+        first = random_scramble(random);
+        second = random_scramble(random);
+
+        const Cube cube(first + second);
+        PackedCube packed(first);
+        Cube applied(first);
+
+        assert(PackedCube(Cube(first)).get_state() == Cube(first).get_state());
+        assert(packed.get_state() == Cube(first).get_state());
+
+        //a sequence moves a cube like its turns, two sequences compose
+        applied.apply(PackedCube(second));
+        packed.apply(PackedCube(second));
+        assert(applied.get_state() == cube.get_state());
+        assert(packed.get_state() == cube.get_state());
+    }
+}
+
+// Every lane of a batch is the sticker cube of its scramble
+static void test_batch(std::mt19937& random) {
+    std::string scrambles[CubeBatch::LANES];
+    bool valid[CubeBatch::LANES];
+    uint8_t moves[CubeBatch::LANES];
+    CubeBatch batch;
+
+    for (int lane = 0; lane < CubeBatch::LANES; lane++) {
+        scrambles[lane] = random_scramble(random);
+    }
+    scrambles[1] = "R U X";
+
+    batch.scramble(scrambles, CubeBatch::LANES, valid);
+
+    for (int lane = 0; lane < CubeBatch::LANES; lane++) {
+        assert(valid[lane] == (lane != 1));
+        assert(batch.get_state(lane) == (lane == 1 ? Cube() : Cube(scrambles[lane])).get_state());
+        moves[lane] = (uint8_t) (lane % 2 == 0 ? Turns::N_MOVES : lane % Turns::N_MOVES);
+    }
+
+    //a different move for every lane, N_MOVES leaves the lane as it is
+    batch.turn(moves);
+
+    for (int lane = 0; lane < CubeBatch::LANES; lane++) {
+        Cube cube = lane == 1 ? Cube() : Cube(scrambles[lane]);
+
+        if (moves[lane] != Turns::N_MOVES) {
+            Turns::turn(cube, moves[lane]);
+        }
+        assert(batch.get_state(lane) == cube.get_state());
+    }
+}
+
+// Letters of the targets of a trace, the edges start at sticker 24
+static std::string letters(const unsigned char* targets, int n, int first) {
+    std::string text;
+
+    for (int i = 0; i < n; i++) {
+        text += (char) ('A' + targets[i] - first);
+    }
+
+    return text;
+}
+
+// The traces from UFR and UF of a few scrambles, with the cycle breaks and the parity
+static void test_trace() {
+    static const struct {
+        const char* scramble;
+        const char* corners;
+        const char* edges;
+    } traces[] = {
+        {"R", "KWQ", "BJVTB"},
+        {"R U R' U'", "KABE", "ABJA"},
+        {"R U", "ADKWQE", "JVTBAD"}
+    };
+    Cubies cubies;
+    Trace trace;
+
+    for (const auto& expected : traces) {
+        Tracing::to_cubies(Cube(expected.scramble), cubies);
+        Tracing::trace(cubies, trace);
+
+        assert(letters(trace.corner_targets, trace.n_corner_targets, 0) == expected.corners);
+        assert(letters(trace.edge_targets, trace.n_edge_targets, 24) == expected.edges);
+        assert(trace.parity == (trace.n_corner_targets % 2 == 1));
+        assert(trace.n_twisted_corners == 0 && trace.n_flipped_edges == 0);
+    }
+
+    //R U R' U' has two corner cycles and one edge cycle, both traces break once
+    Tracing::to_cubies(Cube("R U R' U'"), cubies);
+    Tracing::trace(cubies, trace);
+    assert(trace.corner_cycles == 2 && trace.corner_breaks == 1 && trace.edge_cycles == 1 && trace.edge_breaks == 1);
+
+    //a solved cube has nothing to trace
+    Tracing::to_cubies(Cube(), cubies);
+    Tracing::trace(cubies, trace);
+    assert(trace.n_corner_targets == 0 && trace.n_edge_targets == 0 && !trace.parity);
+}
+
+int main() {
+    std::mt19937 random(42);
+
+    test_turns();
+    test_parse();
+    test_packed(random);
+    test_batch(random);
+    test_trace();
+
+    return 0;
+}
@@ -0,0 +1,429 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the load generator of the solver server: it starts the
+ * server and sends the requests from many clients at the same time: a new
+ * connection for every request, a kept connection, a kept connection with
+ * the requests pipelined or the cubes posted in batches. It prints the
+ * requests per second and the round trip latencies of the ping ("/"), of
+ * the solves of random cubes, of a few cubes asked again with and without
+ * the cache and of the LTCT scrambles. The same solves are sent on the
+ * binary protocol too, on TCP and on a Unix socket.
+ * Run it with the number of clients (default 4), of requests (default 2000)
+ * and the port (default 5014).
+ */
+
+#include <min2phase/min2phase.h>
+#include <min2phase/tools.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * The port of the server.
+ */
+static uint16_t port = 5014;
+
+/**
+ * The number of random cubes of the solve requests.
+ */
+static const int32_t N_CUBES = 256;
+
+/**
+ * The cubes asked again and again by the clients, to load the cache.
+ */
+static const int32_t N_REPEATED = 16;
+
+/**
+ * The requests sent at once by a client with pipelining, and the cubes of
+ * a batch.
+ */
+static const int32_t DEPTH = 16;
+
+/**
+ * The Unix socket of the binary protocol, its TCP port is the one after the
+ * port of the server.
+ */
+static const char UNIX_SOCKET[] = "server-benchmark.sock";
+
+/**
+ * The pause of a paced client between a response and the next request, in
+ * microseconds: the LTCT pools are refilled during the pauses.
+ */
+static const int32_t PAUSE = 20000;
+
+/**
+ * How the clients send the requests.
+ */
+typedef enum {
+    CLOSE,      ///A new connection for every request.
+    KEEP_ALIVE, ///One connection for every client.
+    PIPELINE,   ///One connection, DEPTH requests at a time.
+    BATCH       ///One connection, DEPTH cubes in a POST.
+}Mode;
+
+/**
+ * Open a connection to the server.
+ *
+ * @return      : the socket, -1 if the connection failed.
+ */
+static int32_t connectServer() {
+    struct sockaddr_in address{};
+    int32_t client = socket(AF_INET, SOCK_STREAM, 0), noDelay = 1;
+
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (client < 0 || connect(client, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        close(client);
+        return -1;
+    }
+
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    return client;
+}
+
+/**
+ * Read a response, its body ends after the Content-Length bytes. The bytes
+ * of the next responses are kept in the buffer.
+ *
+ * @param client    : the socket.
+ * @param buffer    : the bytes read and not used yet.
+ * @return          : false if the connection failed or the response is not 200.
+ */
+static bool response(int32_t client, std::string& buffer) {
+    char data[4096];
+    ssize_t size;
+    size_t end, length;
+
+    while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+        if ((size = recv(client, data, sizeof(data), 0)) <= 0)
+            return false;
+        buffer.append(data, (size_t) size);
+    }
+
+    length = std::strtoul(buffer.c_str() + buffer.find("Content-Length: ") + 16, nullptr, 10);
+
+    while (buffer.length() < end + 4 + length) {
+        if ((size = recv(client, data, sizeof(data), 0)) <= 0)
+            return false;
+        buffer.append(data, (size_t) size);
+    }
+
+    const bool ok = buffer.compare(0, 15, "HTTP/1.1 200 OK") == 0;
+    buffer.erase(0, end + 4 + length);
+
+    return ok;
+}
+
+/**
+ * Read a chunked response, a chunk for every solved cube.
+ *
+ * @param client    : the socket.
+ * @param buffer    : the bytes read and not used yet.
+ * @param n         : the number of cubes.
+ * @return          : false if the connection failed or a cube is missing.
+ */
+static bool chunked(int32_t client, std::string& buffer, int32_t n) {
+    char data[4096];
+    ssize_t size;
+    size_t pos = buffer.find("\r\n\r\n"), length;
+    int32_t chunks = 0;
+
+    do {
+        while (pos == std::string::npos || buffer.find("\r\n", pos + 4) == std::string::npos) {
+            if ((size = recv(client, data, sizeof(data), 0)) <= 0)
+                return false;
+            buffer.append(data, (size_t) size);
+
+            if (pos == std::string::npos)
+                pos = buffer.find("\r\n\r\n");
+        }
+
+        length = std::strtoul(buffer.c_str() + pos + 4, nullptr, 16);
+
+        //the chunk is read when its end is in the buffer
+        while (buffer.length() < buffer.find("\r\n", pos + 4) + 4 + length) {
+            if ((size = recv(client, data, sizeof(data), 0)) <= 0)
+                return false;
+            buffer.append(data, (size_t) size);
+        }
+
+        pos = buffer.find("\r\n", pos + 4) + length;
+        chunks += length > 0;
+    } while (length > 0);
+
+    buffer.erase(0, pos + 4);
+
+    return chunks == n;
+}
+
+/**
+ * Send requests and read their responses.
+ *
+ * @param client    : the socket.
+ * @param requests  : the requests, sent at once.
+ * @param n         : the number of requests, or of cubes in a batch.
+ * @param mode      : how the requests are sent.
+ * @return          : false if the connection or a response failed.
+ */
+static bool query(int32_t client, const std::string& requests, int32_t n, Mode mode) {
+    std::string buffer;
+
+    if (send(client, requests.c_str(), requests.length(), MSG_NOSIGNAL) != (ssize_t) requests.length())
+        return false;
+
+    if (mode == BATCH)
+        return chunked(client, buffer, n);
+
+    while (n-- > 0) {
+        if (!response(client, buffer))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Run the requests from the clients and print the throughput and the latencies.
+ *
+ * @param name      : the name of the load.
+ * @param requests  : the requests, taken in turn by the clients, a batch
+ *                    request counts for DEPTH requests.
+ * @param mode      : how the requests are sent.
+ * @param nClients  : the number of clients.
+ * @param count     : the number of requests.
+ */
+static void load(const char* name, const std::vector<std::string>& requests, Mode mode, int32_t nClients, int32_t count) {
+    const int32_t depth = mode == PIPELINE || mode == BATCH ? DEPTH : 1;
+    std::vector<std::thread> clients;
+    std::vector<std::vector<double>> latencies(nClients);
+    std::atomic<int32_t> next(0), failures(0);
+    std::vector<double> all;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int32_t c = 0; c < nClients; c++) {
+        clients.emplace_back([&, c]() {
+            int32_t client = mode == CLOSE ? -1 : connectServer(), i, j;
+            std::string batch;
+
+            while ((i = next.fetch_add(depth)) < count) {
+                const auto sent = std::chrono::steady_clock::now();
+
+                batch.clear();
+                if (mode == BATCH)
+                    batch = requests[(i / depth) % requests.size()];
+
+                for (j = i; mode != BATCH && j < i + depth; j++)
+                    batch += requests[j % requests.size()];
+
+                if (mode == CLOSE) {
+                    batch.insert(batch.length() - 2, "Connection: close\r\n");
+                    client = connectServer();
+                }
+
+                if (client < 0 || !query(client, batch, depth, mode)) {
+                    failures += depth;
+                    close(client);
+                    client = connectServer();
+                }
+
+                if (mode == CLOSE) {
+                    close(client);
+                    client = -1;
+                }
+
+                latencies[c].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+            }
+
+            close(client);
+        });
+    }
+
+    for (std::thread& client : clients)
+        client.join();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const std::vector<double>& l : latencies)
+        all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+
+    std::printf("| %s, %s | %8.0f | %8.0f | %8.0f | %d |\n", name,
+                mode == CLOSE ? "close" : mode == KEEP_ALIVE ? "keep-alive" : mode == PIPELINE ? "pipeline" : "batch",
+                count / seconds, all[all.size() / 2], all[all.size() * 99 / 100], failures.load());
+    std::fflush(stdout);
+}
+
+/**
+ * Solve the cubes from the clients on the binary protocol, DEPTH cubes for
+ * every call, and print the throughput and the latencies of the calls.
+ *
+ * @param name      : the name of the load, with the transport.
+ * @param address   : the address of the server, "host:port" or a Unix socket.
+ * @param cubes     : the cubes, taken in turn by the clients.
+ * @param nClients  : the number of clients.
+ * @param count     : the number of cubes.
+ */
+static void binaryLoad(const char* name, const std::string& address, const std::vector<std::string>& cubes,
+                       int32_t nClients, int32_t count) {
+    std::vector<std::thread> clients;
+    std::vector<std::vector<double>> latencies(nClients);
+    std::atomic<int32_t> next(0), failures(0);
+    std::vector<double> all;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int32_t c = 0; c < nClients; c++) {
+        clients.emplace_back([&, c]() {
+            std::vector<min2phase::RemoteSolution> solutions;
+            std::vector<std::string> batch;
+            int32_t i, j;
+
+            while ((i = next.fetch_add(DEPTH)) < count) {
+                const auto sent = std::chrono::steady_clock::now();
+
+                batch.clear();
+                for (j = i; j < i + DEPTH; j++)
+                    batch.push_back(cubes[j % cubes.size()]);
+
+                if (!min2phase::binarySearch(address, batch, 21, 1000000, 0, 0, solutions))
+                    failures += DEPTH;
+                else
+                    for (const min2phase::RemoteSolution& solution : solutions)
+                        failures += solution.error != 0;
+
+                latencies[c].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+            }
+        });
+    }
+
+    for (std::thread& client : clients)
+        client.join();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const std::vector<double>& l : latencies)
+        all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+
+    std::printf("| %s | %8.0f | %8.0f | %8.0f | %d |\n", name, count / seconds, all[all.size() / 2],
+                all[all.size() * 99 / 100], failures.load());
+    std::fflush(stdout);
+}
+
+/**
+ * Send a request at a time from one client, with a pause after every
+ * response, and print the latencies.
+ *
+ * @param name      : the name of the load.
+ * @param request   : the request.
+ * @param isChunked : true if the response has one chunk, false if it has a length.
+ * @param count     : the number of requests.
+ */
+static void paced(const char* name, const std::string& request, bool isChunked, int32_t count) {
+    const int32_t client = connectServer();
+    std::vector<double> latencies;
+    int32_t failures = 0;
+    std::string buffer;
+
+    for (int32_t i = 0; i < count; i++) {
+        const auto sent = std::chrono::steady_clock::now();
+
+        if (client < 0 || send(client, request.c_str(), request.length(), MSG_NOSIGNAL) < 0 ||
+            !(isChunked ? chunked(client, buffer, 1) : response(client, buffer)))
+            failures++;
+
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+        std::this_thread::sleep_for(std::chrono::microseconds(PAUSE));
+    }
+
+    close(client);
+    std::sort(latencies.begin(), latencies.end());
+
+    std::printf("| %s, paced | %8.0f | %8.0f | %8.0f | %d |\n", name, 1e6 / PAUSE, latencies[latencies.size() / 2],
+                latencies[latencies.size() * 99 / 100], failures);
+    std::fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
+    const int32_t nClients = argc > 1 ? std::stoi(argv[1]) : 4;
+    const int32_t count = argc > 2 ? std::stoi(argv[2]) : 2000;
+    std::vector<std::string> cubes, solves, batches;
+    std::string cube, body, tcp;
+
+    if (argc > 3)
+        port = (uint16_t) std::stoi(argv[3]);
+
+    min2phase::loadFile("coords.m2pc");
+    min2phase::tools::setRandomSeed(42);
+
+    for (int32_t i = 0; i < N_CUBES; i++) {
+        cube = min2phase::tools::randomCube();
+        cubes.push_back(cube);
+        solves.push_back("GET /?c=" + cube + "&m=21&p=1000000 HTTP/1.1\r\n\r\n");
+        body += cube + "\n";
+
+        if ((i + 1) % DEPTH == 0) {
+            batches.push_back("POST /solve?m=21&p=1000000 HTTP/1.1\r\nContent-Length: " + std::to_string(body.length()) +
+                              "\r\n\r\n" + body);
+            body.clear();
+        }
+    }
+
+    tcp = "127.0.0.1:" + std::to_string(port + 1);
+
+    if (!min2phase::server(port) || !min2phase::serverBinary(port + 1, UNIX_SOCKET)) {
+        std::printf("The server did not start.\n");
+        return 1;
+    }
+
+    //the random cubes come back every N_CUBES requests, they are solved without the cache
+    min2phase::serverCache(0);
+
+    std::printf("| %d clients | requests/s | p50 (us) | p99 (us) | failures |\n", nClients);
+    std::printf("|:---|---:|---:|---:|---:|\n");
+    std::fflush(stdout);
+
+    for (Mode mode : {CLOSE, KEEP_ALIVE, PIPELINE}) {
+        load("ping", {"GET / HTTP/1.1\r\n\r\n"}, mode, nClients, count);
+        load("solve", solves, mode, nClients, count);
+    }
+
+    load("solve", batches, BATCH, nClients, count);
+    binaryLoad("solve, binary TCP", tcp, cubes, nClients, count);
+    binaryLoad("solve, binary Unix", UNIX_SOCKET, cubes, nClients, count);
+    load("ltct", {"GET /ltct?target=D&twist=E&n=" + std::to_string(DEPTH) + " HTTP/1.1\r\n\r\n"}, BATCH, nClients, count / 4);
+    load("repeated", std::vector<std::string>(solves.begin(), solves.begin() + N_REPEATED), KEEP_ALIVE, nClients, count);
+    min2phase::serverCache(64 << 20);
+    load("cached", std::vector<std::string>(solves.begin(), solves.begin() + N_REPEATED), KEEP_ALIVE, nClients, count);
+    load("cached", std::vector<std::string>(solves.begin(), solves.begin() + N_REPEATED), PIPELINE, nClients, count * 10);
+    binaryLoad("cached, binary TCP", tcp, std::vector<std::string>(cubes.begin(), cubes.begin() + N_REPEATED), nClients, count * 10);
+    binaryLoad("cached, binary Unix", UNIX_SOCKET, std::vector<std::string>(cubes.begin(), cubes.begin() + N_REPEATED), nClients, count * 10);
+
+    paced("ping", "GET / HTTP/1.1\r\n\r\n", false, count / 20);
+    paced("ltct", "GET /ltct?target=D&twist=E HTTP/1.1\r\n\r\n", true, count / 20);
+
+    min2phase::stop();
+
+    return 0;
+}
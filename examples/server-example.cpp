@@ -11,6 +11,7 @@
 #include <min2phase/tools.h>
 
 #include <iostream>
+#include <vector>
 #include <unistd.h>
 
 /**
@@ -30,13 +31,16 @@ void resSleep(time_t time_s){
 
 int main(int argc, char* argv[]){
     const int32_t port = 5004;
+    const char* names[] = {"U", "U2", "U'", "R", "R2", "R'", "F", "F2", "F'",
+                           "D", "D2", "D'", "L", "L2", "L'", "B", "B2", "B'"};
+    std::vector<min2phase::RemoteSolution> solutions;
     std::string a, timeSol, sol;
     uint8_t usedMoves;
 
     min2phase::loadFile("coords.m2pc");
     min2phase::tools::setRandomSeed(time(nullptr));
 
-    if(min2phase::server(port))
+    if(min2phase::server(port) && min2phase::serverBinary(port + 1, "server-example.sock"))
         std::cout << "Initialized" << std::endl;
     else{
         std::cout << "Error\n";
@@ -50,6 +54,17 @@ int main(int argc, char* argv[]){
     sol = min2phase::webSearch("127.0.0.1", port, min2phase::tools::randomCube(), 21, 1000000, 0, min2phase::USE_SEPARATOR, &usedMoves, &timeSol);
     std::cout << "Web Solver: " << sol << "  " << (int32_t)usedMoves << " moves  " << timeSol << std::endl;
 
+    //solve two cubes on the binary protocol, the moves come as numbers
+    if(min2phase::binarySearch("server-example.sock", {min2phase::tools::randomCube(), min2phase::tools::randomCube()},
+                               21, 1000000, 0, 0, solutions)){
+        for(const min2phase::RemoteSolution& solution : solutions){
+            std::cout << "Binary Solver:";
+            for(uint8_t i = 0; i < solution.length; i++)
+                std::cout << " " << names[solution.moves[i]];
+            std::cout << "  error " << (int32_t)solution.error << std::endl;
+        }
+    }
+
     //wait to stop the server
     std::cin.clear();
     std::cin >> a;
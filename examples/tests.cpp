@@ -9,7 +9,7 @@
 
 #include <min2phase/tools.h>
 
-int main(int argc, char* argv[]){
+int main(){
     min2phase::tools::testAlgorithm();
     return 0;
 }
\ No newline at end of file
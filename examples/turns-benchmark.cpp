@@ -0,0 +1,174 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the benchmark of the sticker cube turns: the copy of the
+ * state done by the old turns, the in place turns, the packed cube and the
+ * batch of cubes, of a scramble parsed every time against the same scramble
+ * precomposed, and of the check of many scrambles one cube at a time against
+ * the batch.
+ * Run it with the number of turns to apply (default 10000000).
+ */
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/cube.h"
+#include "../include/turns.h"
+#include "../include/packed_cube.h"
+#include "../include/cube_batch.h"
+
+// The old turns: copy the state out, rotate the cycles, copy the state back
+static void copy_turn(Cube& cube, int move) {
+    std::array<unsigned short, 54> state = cube.get_state();
+    const int shift = move % 3 + 1;
+    unsigned short values[4];
+
+    for (const auto& cycle : Turns::CYCLES[move / 3]) {
+        for (int j = 0; j < 4; j++) {
+            values[j] = state[cycle[j]];
+        }
+        for (int j = 0; j < 4; j++) {
+            state[cycle[j]] = values[(j + shift) & 3];
+        }
+    }
+    cube.set_state(state);
+}
+
+// A scramble of 25 turns, applied again and again
+static const std::string SCRAMBLE = "R  U2 F' L  D2 B' R2 U' L2 F  D' B2 R' U  F2 L' D  B  R  U2 F' L  D2 B' R2";
+
+// Names of the moves, in the order of Turns::Move
+static const char* const MOVE_NAMES[Turns::N_MOVES] = {
+    "U", "U2", "U'", "L", "L2", "L'", "F", "F2", "F'", "R", "R2", "R'", "B", "B2", "B'", "D", "D2", "D'"
+};
+
+// Runs the turns and returns the nanoseconds per turn
+template<typename T, typename F>
+static double bench(T& cube, const std::vector<unsigned char>& moves, F turn) {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (unsigned char move : moves) {
+        turn(cube, move);
+    }
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / moves.size();
+}
+
+// Applies the scramble and returns the nanoseconds per scramble
+template<typename T, typename F>
+static double bench_scramble(T& cube, size_t count, F scramble) {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < count; i++) {
+        scramble(cube);
+    }
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 10000000;
+    const PackedCube sequence(SCRAMBLE);
+    std::vector<unsigned char> moves(count);
+    std::mt19937 random(42);
+    Cube copied, in_place, parsed, composed;
+    PackedCube packed, packed_parsed, packed_composed;
+    CubeBatch batch;
+    std::vector<std::string> scrambles(count / 25);
+    std::vector<char> verdicts(scrambles.size());
+    std::unique_ptr<bool[]> batch_verdicts(new bool[scrambles.size()]);
+    size_t step = 0;
+    double times[10];
+
+    for (unsigned char& move : moves) {
+        move = (unsigned char) (random() % Turns::N_MOVES);
+    }
+
+    times[0] = bench(copied, moves, copy_turn);
+    times[1] = bench(in_place, moves, Turns::turn);
+    times[2] = bench(packed, moves, [](PackedCube& cube, int move) { cube.turn(move); });
+
+    times[3] = bench_scramble(batch, count / CubeBatch::LANES, [&moves, &step](CubeBatch& cubes) {
+        cubes.turn(&moves[step++ * CubeBatch::LANES]);
+    }) / CubeBatch::LANES;
+
+    times[4] = bench_scramble(parsed, count / 25, [](Cube& cube) { cube.scramble_cube(SCRAMBLE); });
+    times[5] = bench_scramble(composed, count / 25, [&sequence](Cube& cube) { cube.apply(sequence); });
+    times[6] = bench_scramble(packed_parsed, count / 25, [](PackedCube& cube) { cube.scramble_cube(SCRAMBLE); });
+    times[7] = bench_scramble(packed_composed, count / 25, [&sequence](PackedCube& cube) { cube.apply(sequence); });
+
+    for (std::string& scramble : scrambles) {
+        for (int i = 0; i < 25; i++) {
+            scramble += MOVE_NAMES[random() % Turns::N_MOVES];
+            scramble += ' ';
+        }
+    }
+
+    times[8] = bench_scramble(verdicts, 1, [&scrambles](std::vector<char>& results) {
+        for (size_t i = 0; i < scrambles.size(); i++) {
+            Cube cube(scrambles[i]);
+
+            results[i] = cube.check_ltct('A', 'C');
+        }
+    }) / scrambles.size();
+    times[9] = bench_scramble(batch_verdicts, 1, [&scrambles](std::unique_ptr<bool[]>& results) {
+        CubeBatch::audit(scrambles.data(), scrambles.size(), 'A', 'C', results.get());
+    }) / scrambles.size();
+
+    if (copied.get_state() != in_place.get_state() || copied.get_state() != packed.get_state()) {
+        std::printf("The turns do not give the same state.\n");
+        return 1;
+    }
+
+    for (int lane = 0; lane < CubeBatch::LANES; lane++) {
+        Cube cube;
+
+        for (step = 0; step < count / CubeBatch::LANES; step++) {
+            Turns::turn(cube, moves[step * CubeBatch::LANES + lane]);
+        }
+        if (cube.get_state() != batch.get_state(lane)) {
+            std::printf("The batch does not give the same state.\n");
+            return 1;
+        }
+    }
+
+    for (size_t i = 0; i < scrambles.size(); i++) {
+        if ((verdicts[i] != 0) != batch_verdicts[i]) {
+            std::printf("The batch does not give the same verdicts.\n");
+            return 1;
+        }
+    }
+
+    if (parsed.get_state() != composed.get_state() || parsed.get_state() != packed_parsed.get_state()
+        || parsed.get_state() != packed_composed.get_state()) {
+        std::printf("The sequences do not give the same state.\n");
+        return 1;
+    }
+
+    std::printf("| Turns | ns/turn |\n");
+    std::printf("|:---|---:|\n");
+    std::printf("| copy of the state | %.2f |\n", times[0]);
+    std::printf("| in place | %.2f |\n", times[1]);
+    std::printf("| packed | %.2f |\n", times[2]);
+    std::printf("| batch of %d, per cube | %.2f |\n", CubeBatch::LANES, times[3]);
+    std::printf("\n| 25 turns scramble | ns/scramble |\n");
+    std::printf("|:---|---:|\n");
+    std::printf("| parsed | %.2f |\n", times[4]);
+    std::printf("| precomposed | %.2f |\n", times[5]);
+    std::printf("| packed, parsed | %.2f |\n", times[6]);
+    std::printf("| packed, precomposed | %.2f |\n", times[7]);
+    std::printf("\n| LTCT check of 25 turns scrambles | ns/scramble |\n");
+    std::printf("|:---|---:|\n");
+    std::printf("| one cube at a time | %.2f |\n", times[8]);
+    std::printf("| batch | %.2f |\n", times[9]);
+
+    return 0;
+}
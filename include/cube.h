@@ -4,12 +4,15 @@
 #include <array>
 #include <string>
 
+class PackedCube;
+
 class Cube {
     public:
         // Default constructor (solved cube)
         Cube();
 
-        // Parameter constructor with an initial scramble
+        // Parameter constructor with an initial scramble, the cube stays
+        // solved if the scramble is malformed
         Cube(const std::string& init_scramble);
 
         // Method for printing the current cube state in an understandable format
@@ -21,8 +24,13 @@ class Cube {
         // Method for printing the current state to stdout
         void print_state() const;
         
-        // Method for scrambling a cube with a given scramble
-        void scramble_cube(const std::string& scramble);
+        // Method for scrambling a cube with a given scramble, returns false
+        // and leaves the cube unchanged if the scramble is malformed
+        bool scramble_cube(const std::string& scramble);
+
+        // Method for applying a precomposed sequence of turns with a single
+        // gather of the stickers
+        void apply(const PackedCube& sequence);
 
         // Method for retrieving the scramble of the cube
         std::string get_scramble() const;
@@ -44,6 +52,10 @@ class Cube {
 
         bool check_ltct(int final_target, int corner_twist);
     private:
+        // The turns edit the state in place, the tracing reads it
+        friend class Turns;
+        friend class Tracing;
+
         // Saving the initial scramble in the scramble object
         std::string scramble = "";
 
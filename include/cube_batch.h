@@ -0,0 +1,55 @@
+#ifndef CUBE_BATCH_H
+#define CUBE_BATCH_H
+
+#include "cube.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Many cubes turned together for the offline checks of the scrambles. The
+// state is one row per sticker with one byte per cube (lane): a turn is the
+// same vector blends for every lane, each lane can do a different move
+class CubeBatch {
+    public:
+        // Number of cubes of the batch, one AVX-512 register per sticker
+        static constexpr int LANES = 64;
+
+        // Number of stickers of the state, the centers never move
+        static constexpr int N_STICKERS = 48;
+
+        // Longest scramble accepted by scramble
+        static constexpr int MAX_MOVES = 64;
+
+        // Default constructor (solved cubes)
+        CubeBatch();
+
+        // Method for solving all the cubes
+        void reset();
+
+        // Applies moves[lane] (Turns::Move) to every lane, N_MOVES leaves
+        // the lane unchanged
+        void turn(const uint8_t* moves);
+
+        // Solves the cubes and applies a scramble to each of the first count
+        // lanes. valid[lane] is false for the malformed scrambles and the
+        // ones longer than MAX_MOVES, their lane stays solved
+        void scramble(const std::string* scrambles, int count, bool* valid);
+
+        // Method for retrieving the state of a cube
+        std::array<unsigned short, 54> get_state(int lane) const;
+
+        // Runs Tracing::verify_ltct on the first count lanes
+        void verify_ltct(char target, char twist, bool* verdicts, int count = LANES) const;
+
+        // Checks a whole list of scrambles, LANES at a time: the verdict is
+        // false for the malformed scrambles
+        static void audit(const std::string* scrambles, size_t count, char target, char twist, bool* verdicts);
+
+    private:
+        // One row of LANES bytes per sticker, aligned for the vector registers
+        alignas(LANES) uint8_t state[N_STICKERS][LANES];
+};
+
+#endif // CUBE_BATCH_H
@@ -0,0 +1,77 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Exact set of cube states for the de-duplication of the generated cubes. A
+// state is its 128 bits key (min2phase::tools::stateKey), the top bits of its
+// hash choose one of the shards so many threads can insert at the same time,
+// every shard is an open addressing table
+class StateSet {
+    public:
+        // Number of shards, each one with its own lock
+        static constexpr int N_SHARDS = 64;
+
+        // Constructor, the tables are sized for the expected number of states
+        explicit StateSet(size_t expected = 0);
+
+        // Adds a state, returns false if it was already in the set
+        bool insert(const uint64_t key[2]);
+
+        // Checks if a state is in the set
+        bool contains(const uint64_t key[2]) const;
+
+        // Number of states of the set
+        size_t size() const;
+
+        // Bytes used by the tables
+        size_t memory() const;
+
+    private:
+        // A table with its lock, on its own cache line
+        struct alignas(64) Shard {
+            mutable std::mutex lock;
+            std::vector<std::array<uint64_t, 2>> slots;
+            size_t count = 0;
+        };
+
+        std::array<Shard, N_SHARDS> shards;
+};
+
+// Approximate set of cube states for the runs too large for StateSet: a bloom
+// filter on the hash of the keys. A new state can be taken for a duplicate
+// with the chosen probability, a duplicate is never taken for a new state.
+// The bits of a state are all in a block of 64 bytes, they are atomic so many
+// threads can insert without locks
+class BloomFilter {
+    public:
+        // Constructor, the bits are sized for the expected number of states
+        // and the false positive rate
+        BloomFilter(size_t expected, double false_positive);
+
+        // Adds a state, returns false if it was (probably) already in the set
+        bool insert(const uint64_t key[2]);
+
+        // Checks if a state is (probably) in the set
+        bool contains(const uint64_t key[2]) const;
+
+        // Bytes used by the bits
+        size_t memory() const;
+
+        // Number of bits set for every state
+        int hashes() const;
+
+    private:
+        std::unique_ptr<std::atomic<uint64_t>[]> words;
+        // Number of blocks minus one
+        uint64_t mask;
+        int n_hashes;
+};
+
+#endif
@@ -20,8 +20,10 @@
 #ifndef MIN2PHASE
 #define MIN2PHASE 1
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 /**
  * Used to print the info of the solver.
@@ -66,13 +68,49 @@ namespace min2phase{
      */
     const int8_t OPTIMAL_SOLUTION = 0x8;
 
+    /**
+     * A solution from the binary protocol of the server. The moves go from
+     * 0 to 17 in the order U U2 U' R R2 R' F F2 F' D D2 D' L L2 L' B B2 B'.
+     */
+    typedef struct {
+        int8_t error;     ///0, the error of the solve, 64 if the server was busy or 65 if the request was malformed.
+        uint8_t length;   ///The number of moves.
+        int8_t moves[32]; ///The moves of the solution.
+    }RemoteSolution;
+
+    /**
+     * The set of tables computed by the initialization. A bigger set uses
+     * more memory and a longer initialization, but the search visits less
+     * nodes. See Benchmarks.md for the memory and speed of each set.
+     */
+    typedef enum : int8_t {
+        MINIMAL_TABLES = 0,  ///Without the twist-flip pruning, for the small boards.
+        STANDARD_TABLES = 1, ///The tables of the min2phase Java algorithm.
+        LARGE_TABLES = 2     ///With the corner permutation and orientation pruning, for the optimal solutions.
+    }Profile;
+
     /**
      * This function compute all the variable necessary for te algorithm.
+     *
+     * @param profile   : the set of tables to compute.
+     */
+    void init(Profile profile = STANDARD_TABLES);
+
+    /**
+     * This function compute the variables needed to start solving and returns,
+     * the phase 1 pruning tables are computed by a background thread. Until
+     * they are ready the solver uses weaker bounds, so the first solutions
+     * are correct but slower to find.
+     *
+     * @param profile   : the set of tables to compute.
      */
-    void init();
+    void initAsync(Profile profile = STANDARD_TABLES);
 
     /**
-     * Write all the coordinates into a binary file.
+     * Write all the coordinates into a binary file. The file does not depend
+     * on the machine: it is little endian, without padding and with explicit
+     * sizes, so it can be generated on a PC and loaded on an ARM board.
+     * Only the tables of the current profile are written.
      *
      * @param name      : the name and path of the file.
      * @return          : true if the file was written, false if not.
@@ -80,12 +118,27 @@ namespace min2phase{
     bool writeFile(const std::string& name);
 
     /**
-     * Load all the coordinates from a binary file.
+     * Load all the coordinates from a binary file. If the file is missing,
+     * corrupted or written by another version, the coordinates are computed
+     * with initAsync. The file must be written with the same set of tables.
      *
      * @param name      : the name and path of the file.
+     * @param profile   : the set of tables stored in the file.
      * @return          : true if the file was red, false if not.
      */
-    bool loadFile(const std::string& name);
+    bool loadFile(const std::string& name, Profile profile = STANDARD_TABLES);
+
+    /**
+     * Move the tables on 2 MB huge pages or back on normal pages. The tables
+     * are bigger than a megabyte and the search reads them at random, so
+     * huge pages reduce the TLB misses. It tries an explicit hugetlbfs mapping
+     * first and falls back to transparent huge pages. It can be called before
+     * or after the initialization, but not while a cube is being solved.
+     *
+     * @param enable    : true to use huge pages, false to use normal pages.
+     * @return          : true if the tables are on huge pages, false if not.
+     */
+    bool hugePages(bool enable = true);
 
     /**
      * This is used to solve the cube. It has many configuration in base of the
@@ -133,10 +186,30 @@ namespace min2phase{
     std::string solve(const std::string& facelets, int8_t maxDepth, int32_t probeMax, int32_t probeMin, int8_t verbose, uint8_t* usedMoves = nullptr);
 
     /**
-     * This is used to init and http server.
-     *
-     * @warning: this function will abilitate an handler for the zombie process,
-     *           do not register another handler with SIGCHLD.
+     * This is used to init and http server. An event loop thread accepts
+     * the connections and reads the requests, a pool of solver threads
+     * (one per core, each with its own search) computes the responses.
+     * The requests are HTTP GET: "/" answers "k", "/r" a random cube and
+     * "/?c=facelets&m=21&p=100000&P=0&v=0" the solution, the parameters
+     * but c can be left out. The connections are kept open and the
+     * requests can be pipelined, the responses come in their order.
+     * "POST /solve?m=21&p=100000&P=0&v=0" solves the cubes of the body,
+     * one per line or a JSON array of strings, on all the solver threads:
+     * the solutions are streamed with the chunked encoding as they are
+     * found, one line "index solution" per cube.
+     * "/ltct?target=X&twist=Y&n=N" streams N scrambles (default 1) of
+     * the LTCT case in the same way, one per line, each one checked
+     * against its cube (twist 'C' is no twist, see tools::validLtct):
+     * the scrambles of a case are made ahead in a pool. The solutions
+     * are cached, see serverCache. "/stats" shows the cache and the pools
+     * and "/metrics" the counters of the requests, the latency of the
+     * solves and the lengths of the solutions for Prometheus.
+     * A request has t milliseconds (default 10000) from when it is read:
+     * the searches stop at the deadline with the best solution found or
+     * with the error 10 (TIME_LIMIT), and also when the client goes away. The
+     * requests that need a solver thread are refused with 503 when 64
+     * jobs per thread are waiting. A batch counts as one request, it has
+     * at most one cube per thread waiting at a time.
      *
      * @param port      : the port of the server.
      * @pram mReq       : (Optional) the max number of requests.
@@ -145,7 +218,31 @@ namespace min2phase{
     bool server(uint16_t port, uint16_t mReq = 10000);
 
     /**
-     * This stops the solver server. It also remove the SIGCHLD signal handler.
+     * Serve also the binary protocol: the cubes come packed as the key of
+     * their state (see tools::stateKey) and the solutions go back as
+     * arrays of moves, with no text to format or to parse. It uses the
+     * solver threads, the cache and the limits of the server, which must
+     * be running.
+     *
+     * @param port      : the TCP port, 0 for none.
+     * @param path      : (Optional) the path of the Unix socket, empty for none.
+     * @return          : true if it was done correctly, false if not.
+     */
+    bool serverBinary(uint16_t port, const std::string& path = "");
+
+    /**
+     * Set the memory of the cache of the solutions of the server: the
+     * solutions are kept by the state of the cube and the parameters of
+     * the solve, the least recently used ones are removed first.
+     *
+     * @param bytes     : the limit in bytes, 0 turns the cache off. The
+     *                    server starts with 64 MiB.
+     */
+    void serverCache(size_t bytes);
+
+    /**
+     * This stops the solver server and waits for its threads. The
+     * searches in progress are stopped and the queued requests dropped.
      *
      * @return          : true if it was done correctly, false if not.
      */
@@ -153,7 +250,8 @@ namespace min2phase{
 
     /**
      * Remote cube solver. It connects form a remote cube solver server and
-     * ask the solution of the cube.
+     * ask the solution of the cube. The connection is kept open for the
+     * next requests of the same thread to the same server.
      *
      * @see: the local solver documentation
      *
@@ -173,6 +271,26 @@ namespace min2phase{
                           int32_t probeMax, int32_t probeMin,
                           int8_t verbose, uint8_t* usedMoves = nullptr,
                           std::string *time = nullptr);
+
+    /**
+     * Remote cube solver on the binary protocol (see serverBinary). All
+     * the cubes are sent on one connection without waiting for the
+     * solutions, up to 64 at a time. The connection is kept open for the
+     * next calls of the same thread to the same server.
+     *
+     * @param address   : "host:port" for TCP or the path of a Unix socket.
+     * @param cubes     : the cubes, like the ones of the local solver.
+     * @param maxDepth  : the max of moves used to solve a cube.
+     * @param probeMax  : the max of cube explored in phase 2.
+     * @param probeMin  : the min of cube explored in phase 2.
+     * @param verbose   : INVERSE_SOLUTION and OPTIMAL_SOLUTION are used.
+     * @param solutions : where to store the solutions, in the order of the cubes.
+     * @param timeout   : (Optional) the time of a cube in milliseconds, 0 for the one of the server.
+     * @return          : false if the server could not be reached.
+     */
+    bool binarySearch(const std::string& address, const std::vector<std::string>& cubes, int8_t maxDepth,
+                      int32_t probeMax, int32_t probeMin, int8_t verbose, std::vector<RemoteSolution>& solutions,
+                      uint32_t timeout = 0);
 }
 
 #endif //MIN2PHASE
\ No newline at end of file
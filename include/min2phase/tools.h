@@ -30,12 +30,67 @@ namespace min2phase { namespace tools {
     void setRandomSeed(uint32_t seed);
 
     /**
-     * This is used to get a random cube state.
+     * This is used to get a random cube state. The corners and the edges
+     * are drawn again until they satisfy the constraints, see addConstraint.
+     * With a target the cube is an LTCT case, see isLtct: the cases that
+     * are not valid make it loop forever, see validLtct.
      *
-     * @return : the string that contains the random cube.
+     * @param target : the last corner target (Speffz), 'C' for any.
+     * @param twist  : the twisted corner (Speffz), 'C' for none.
+     * @return       : the string that contains the random cube.
      */
     std::string randomCube(char target = 'C', char twist = 'C');
 
+    /**
+     * Check if a cube is an LTCT case: the corners have odd parity, they
+     * are a single cycle from the buffer (UFR) that ends on the target with
+     * the sticker of the twist, and only the corner of the twist is
+     * twisted in its position.
+     *
+     * @param facelets : the cube.
+     * @param target   : the last corner target (Speffz).
+     * @param twist    : the twisted corner (Speffz), 'C' for none.
+     * @return         : true if the cube is the case.
+     */
+    bool isLtct(const std::string& facelets, char target, char twist = 'C');
+
+    /**
+     * Check if an LTCT case has cubes: the target is a corner sticker not
+     * on the buffer and the twist is 'C' or a side sticker (not U or D) of a corner that is
+     * not the buffer or the one of the target.
+     *
+     * @param target   : the last corner target (Speffz).
+     * @param twist    : the twisted corner (Speffz), 'C' for none.
+     * @return         : true if randomCube can find the case.
+     */
+    bool validLtct(char target, char twist = 'C');
+
+    /**
+     * Add a constraint on the blindfold trace (buffers UFR and UF) of the
+     * random cubes. The rule is "name=value" or "name=min-max" with the
+     * names corner-targets, corner-cycles, twists, edge-targets,
+     * edge-cycles and flips, or "parity-target=letter" for the last edge
+     * target in Speffz. The rules that no cube satisfies make randomCube
+     * loop forever. It is not thread safe.
+     *
+     * @param rule : the rule.
+     * @return     : false if the rule is malformed or out of range.
+     */
+    bool addConstraint(const std::string& rule);
+
+    /**
+     * Remove every constraint on the random cubes.
+     */
+    void clearConstraints();
+
+    /**
+     * Get the acceptance rate of every constraint, one line per
+     * constraint.
+     *
+     * @return : the cubes checked and accepted by every constraint.
+     */
+    std::string constraintsReport();
+
     /**
      * Generate a cube from a scramble.
      *
@@ -57,6 +112,24 @@ namespace min2phase { namespace tools {
      */
     void benchmark();
 
+    /**
+     * Print the solve throughput with the tables on normal pages and
+     * on huge pages.
+     */
+    void benchmarkHugePages();
+
+    /**
+     * Print the initialization time, the resident memory and the solve
+     * speed of every set of tables, see min2phase::Profile.
+     */
+    void benchmarkProfiles();
+
+    /**
+     * Print the time of the rank and unrank of the permutation and
+     * combination coordinates of the cubie cube.
+     */
+    void benchmarkCoordinates();
+
     /**
      * Check if the cube is in a correct input.
      *
@@ -64,6 +137,24 @@ namespace min2phase { namespace tools {
      */
     int8_t verify(const std::string& facelets);
 
+    /**
+     * Get the key of the state of a cube: two cubes have the same key
+     * only if they have the same state, whatever the colors are.
+     *
+     * @param facelets : the cube.
+     * @param key      : the array to store the key.
+     * @return         : false if the cube is not solvable.
+     */
+    bool stateKey(const std::string& facelets, uint64_t key[2]);
+
+    /**
+     * Hash a key of a state, the hash is the same on every platform.
+     *
+     * @param key : the key of the state.
+     * @return    : the 64 bits hash.
+     */
+    uint64_t stateHash(const uint64_t key[2]);
+
     /**
      * Tests the algorithm.
      */
@@ -0,0 +1,52 @@
+#ifndef PACKED_CUBE_H
+#define PACKED_CUBE_H
+
+#include "cube.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+class PackedCube {
+    public:
+        // Number of bytes of the state, the stickers after 54 never move
+        static constexpr int SIZE = 64;
+
+        // Default constructor (solved cube)
+        PackedCube();
+
+        // Conversion from the sticker cube
+        explicit PackedCube(const Cube& cube);
+
+        // Parameter constructor with an initial scramble, the cube stays
+        // solved if the scramble is malformed
+        explicit PackedCube(const std::string& scramble);
+
+        // Applies a turn (Turns::Move) with a single byte shuffle
+        void turn(int move);
+
+        // Method for scrambling a cube with a given scramble, returns false
+        // and leaves the cube unchanged if the scramble is malformed
+        bool scramble_cube(const std::string& scramble);
+
+        // A cube that starts solved holds the permutation of all the turns
+        // applied to it: apply moves this cube by the whole sequence with a
+        // single byte shuffle, and composes two sequences (a.apply(b) is a
+        // followed by b)
+        void apply(const PackedCube& sequence);
+
+        // The sticker that the sequence moves to a place
+        uint8_t source(int sticker) const;
+
+        // Method for retrieving the current cube state
+        std::array<unsigned short, 54> get_state() const;
+
+        // Method for checking if the cube is solved
+        bool is_solved() const;
+
+    private:
+        // One byte per sticker, aligned for the vector registers
+        alignas(SIZE) std::array<uint8_t, SIZE> state;
+};
+
+#endif // PACKED_CUBE_H
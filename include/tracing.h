@@ -2,12 +2,71 @@
 #define TRACING_H
 
 #include "cube.h"
-#include <vector>
+
+// Corners and edges of a cube as pieces and orientations. The positions are
+// ULB, URB, URF, ULF, DLF, DRF, DRB, DLB for the corners and UB, UR, UF, UL,
+// FR, FL, BR, BL, DF, DR, DB, DL for the edges. The orientation is the
+// sticker of the position (clockwise for the corners) that shows the U/D
+// sticker of the piece, the F/B one for the edges of the E slice
+struct Cubies {
+    unsigned char cp[8];
+    unsigned char co[8];
+    unsigned char ep[12];
+    unsigned char eo[12];
+};
+
+// Blindfold trace of a cube, the targets are sticker indices (Speffz letter - 'A'
+// for the corners, 24 + letter - 'A' for the edges)
+struct Trace {
+    // One target per piece and one more per cycle break
+    static constexpr int MAX_CORNER_TARGETS = 7 + 3;
+    static constexpr int MAX_EDGE_TARGETS = 11 + 5;
+
+    unsigned char corner_targets[MAX_CORNER_TARGETS];
+    unsigned char edge_targets[MAX_EDGE_TARGETS];
+    unsigned char n_corner_targets;
+    unsigned char n_edge_targets;
+
+    // Solved corners and edges with a wrong orientation, as the sticker that
+    // shows their U/D (F/B) sticker, the buffers are left out
+    unsigned char twisted_corners[8];
+    unsigned char flipped_edges[12];
+    unsigned char n_twisted_corners;
+    unsigned char n_flipped_edges;
+
+    // Cycles of the permutations (longer than 1) and cycle breaks of the trace
+    unsigned char corner_cycles;
+    unsigned char edge_cycles;
+    unsigned char corner_breaks;
+    unsigned char edge_breaks;
+
+    // Odd number of corner targets
+    bool parity;
+};
 
 class Tracing {
     public:
-        // Traces the corners and sets the parity
+        // Buffers of the default trace: UFR and UF
+        static constexpr int CORNER_BUFFER = 2;
+        static constexpr int EDGE_BUFFER = 26;
+
+        // Reads the pieces of the cube from its stickers
+        static void to_cubies(const Cube& cube, Cubies& cubies);
+
+        // Reads the pieces from one byte per sticker, the centers are not read
+        static void to_cubies(const unsigned char* stickers, Cubies& cubies);
+
+        // Traces corners and edges in one pass, the buffers can be any sticker
+        // of the buffer pieces
+        static void trace(const Cubies& cubies, Trace& trace,
+                          int corner_buffer = CORNER_BUFFER, int edge_buffer = EDGE_BUFFER);
+
+        // Checks the corners for the last target and the twist, the parity is
+        // set for the cubes that are traced
         static bool verify_ltct(Cube& cube, char target, char twist);
+
+        // Same check on the pieces of a cube, the parity is not kept
+        static bool verify_ltct(const Cubies& cubies, char target, char twist);
 };
 
 #endif
@@ -3,27 +3,49 @@
 
 #include "cube.h"
 
+#include <string>
+
 class Turns {
     public:
-        // Implementation of every single turn
-        static void turn_u(Cube& cube);
-        static void turn_u2(Cube& cube);
-        static void turn_u_prime(Cube& cube);
-        static void turn_l(Cube& cube);
-        static void turn_l2(Cube& cube);
-        static void turn_l_prime(Cube& cube);
-        static void turn_f(Cube& cube);
-        static void turn_f2(Cube& cube);
-        static void turn_f_prime(Cube& cube);
-        static void turn_r(Cube& cube);
-        static void turn_r2(Cube& cube);
-        static void turn_r_prime(Cube& cube);
-        static void turn_b(Cube& cube);
-        static void turn_b2(Cube& cube);
-        static void turn_b_prime(Cube& cube);
-        static void turn_d(Cube& cube);
-        static void turn_d2(Cube& cube);
-        static void turn_d_prime(Cube& cube);
+        // Index of every turn, face * 3 + power (quarter, half, prime)
+        enum Move {
+            U, U2, U_PRIME, L, L2, L_PRIME, F, F2, F_PRIME,
+            R, R2, R_PRIME, B, B2, B_PRIME, D, D2, D_PRIME,
+            N_MOVES
+        };
+
+        // Number of faces and of sticker cycles of a face turn
+        static constexpr int N_FACES = 6;
+        static constexpr int N_CYCLES = 5;
+
+        // Number of stickers moved by a turn
+        static constexpr int N_MOVED = N_CYCLES * 4;
+
+        // Sticker cycles of the quarter turn of every face (U, L, F, R, B, D):
+        // the sticker at cycle[i] takes the value at cycle[(i + 1) % 4]
+        static constexpr unsigned char CYCLES[N_FACES][N_CYCLES][4] = {
+            {{0, 3, 2, 1}, {4, 8, 12, 16}, {5, 9, 13, 17}, {24, 27, 26, 25}, {28, 32, 36, 40}},
+            {{4, 7, 6, 5}, {0, 18, 20, 8}, {3, 17, 23, 11}, {28, 31, 30, 29}, {27, 41, 47, 35}},
+            {{8, 11, 10, 9}, {2, 5, 20, 15}, {3, 6, 21, 12}, {32, 35, 34, 33}, {26, 29, 44, 39}},
+            {{12, 15, 14, 13}, {1, 9, 21, 19}, {2, 10, 22, 16}, {36, 39, 38, 37}, {25, 33, 45, 43}},
+            {{16, 19, 18, 17}, {0, 13, 22, 7}, {1, 14, 23, 4}, {40, 43, 42, 41}, {24, 37, 46, 31}},
+            {{20, 23, 22, 21}, {6, 18, 14, 10}, {7, 19, 15, 11}, {44, 47, 46, 45}, {30, 42, 38, 34}}
+        };
+
+        // Returned by parse_move for a token that is not a turn
+        static constexpr int INVALID_MOVE = -1;
+
+        // Applies a turn in place, without copying the state
+        static void turn(Cube& cube, int move);
+
+        // Reads the next turn of a scramble and moves text after it, spaces
+        // are skipped. Returns the move, N_MOVES at the end of the text or
+        // INVALID_MOVE (text is left on the bad token)
+        static int parse_move(const char*& text, const char* end);
+
+        // Parses a whole scramble into the moves buffer. Returns the number
+        // of moves, or -1 if the scramble is malformed or longer than max_moves
+        static int parse(const std::string& scramble, unsigned char* moves, int max_moves);
 };
 
 #endif // TURNS_H
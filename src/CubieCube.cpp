@@ -125,82 +125,198 @@ namespace min2phase {
         return info::NO_ERROR;
     }
 
-    //convert the array of colors into a cube object
-    void CubieCube::toCubieCube(const int8_t f[], CubieCube &ccRet) {
-        int8_t ori, i, j, col1, col2;
+    /**
+     * The facelets of a solved cube, the centers never change.
+     */
+    static const char SOLVED_FACELETS[] = "UUUUUUUUURRRRRRRRRFFFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB";
+
+    /**
+     * The number of values of a corner (ori << 3 | corner) or edge (edge << 1 | ori).
+     */
+    static const int8_t N_CUBIE_VALUES = 24;
+
+    /**
+     * The tables of the conversions between facelets and cubies.
+     */
+    typedef struct faceletTables_s {
+        /**
+         * The facelets of every value of a corner, in the order of the facelets
+         * of the position.
+         */
+        char cornerColors[N_CUBIE_VALUES][info::CORNE_ORI_CASES];
+
+        /**
+         * The facelets of every value of an edge, in the order of the facelets
+         * of the position.
+         */
+        char edgeColors[N_CUBIE_VALUES][info::EDGE_ORI_CASES];
+
+        /**
+         * The value of a corner from the colors of the facelets of its position
+         * (c0 * 36 + c1 * 6 + c2), 0 if there is no such corner.
+         */
+        int8_t cornerValue[info::FACES * info::FACES * info::FACES];
+
+        /**
+         * The value of an edge from the colors of the facelets of its position
+         * (c0 * 6 + c1), 0 if there is no such edge.
+         */
+        int8_t edgeValue[info::FACES * info::FACES];
+    }faceletTables_t;
+
+    /**
+     * Build the tables of the conversions, the values are the same of the
+     * search of every corner and edge between all of them.
+     *
+     * @return  : the tables.
+     */
+    static constexpr faceletTables_t faceletTables() {
+        const char ts[] = {'U', 'R', 'F', 'D', 'L', 'B'};
+        faceletTables_t t{};
+        int8_t c[info::CORNE_ORI_CASES] = {0, 0, 0};
+        int8_t j = 0, n = 0, ori = 0;
+        int16_t i = 0;
+
+        for (i = 0; i < N_CUBIE_VALUES; i++) {
+            for (n = 0; n < info::CORNE_ORI_CASES; n++)
+                t.cornerColors[i][(n + (i >> 3)) % info::CORNE_ORI_CASES] =
+                        ts[info::cornerFacelet[i & 7][n] / info::N_PLATES_X_FACE];
+
+            for (n = 0; n < info::EDGE_ORI_CASES; n++)
+                t.edgeColors[i][(n + (i & 1)) % info::EDGE_ORI_CASES] =
+                        ts[info::edgeFacelet[i >> 1][n] / info::N_PLATES_X_FACE];
+        }
 
-        for (i = 0; i < info::NUMBER_CORNER; i++)
-            ccRet.corners[i] = 0;
+        for (i = 0; i < info::FACES * info::FACES * info::FACES; i++) {
+            c[0] = (int8_t) (i / (info::FACES * info::FACES));
+            c[1] = (int8_t) (i / info::FACES % info::FACES);
+            c[2] = (int8_t) (i % info::FACES);
 
-        for (i = 0; i < info::NUMBER_EDGES; i++)
-            ccRet.edges[i] = 0;
-
-        for (i = 0; i < info::NUMBER_CORNER; i++) {
             for (ori = 0; ori < info::CORNE_ORI_CASES; ori++)
-                if (f[info::cornerFacelet[i][ori]] == info::U ||
-                    f[info::cornerFacelet[i][ori]] == info::D)
+                if (c[ori] == info::U || c[ori] == info::D)
                     break;
 
-            col1 = f[info::cornerFacelet[i][(ori + 1) % info::CORNE_ORI_CASES]];
-            col2 = f[info::cornerFacelet[i][(ori + 2) % info::CORNE_ORI_CASES]];
-
             for (j = 0; j < info::NUMBER_CORNER; j++) {
-                if (col1 == info::cornerFacelet[j][1] / 9 && col2 == info::cornerFacelet[j][2] / 9) {
-                    ccRet.corners[i] = (int8_t)(ori % info::CORNE_ORI_CASES << info::CORNE_ORI_CASES | j);
+                if (c[(ori + 1) % info::CORNE_ORI_CASES] == info::cornerFacelet[j][1] / info::N_PLATES_X_FACE &&
+                    c[(ori + 2) % info::CORNE_ORI_CASES] == info::cornerFacelet[j][2] / info::N_PLATES_X_FACE) {
+                    t.cornerValue[i] = (int8_t) (ori % info::CORNE_ORI_CASES << info::CORNE_ORI_CASES | j);
                     break;
                 }
             }
         }
 
-        for (i = 0; i < info::NUMBER_EDGES; i++) {
+        for (i = 0; i < info::FACES * info::FACES; i++) {
+            c[0] = (int8_t) (i / info::FACES);
+            c[1] = (int8_t) (i % info::FACES);
+
             for (j = 0; j < info::NUMBER_EDGES; j++) {
-                if (f[info::edgeFacelet[i][0]] == info::edgeFacelet[j][0] / 9
-                    && f[info::edgeFacelet[i][1]] == info::edgeFacelet[j][1] / 9) {
-                    ccRet.edges[i] = j << 1;
+                if (c[0] == info::edgeFacelet[j][0] / info::N_PLATES_X_FACE &&
+                    c[1] == info::edgeFacelet[j][1] / info::N_PLATES_X_FACE) {
+                    t.edgeValue[i] = (int8_t) (j << 1);
                     break;
                 }
 
-                if (f[info::edgeFacelet[i][0]] == info::edgeFacelet[j][1] / 9
-                    && f[info::edgeFacelet[i][1]] == info::edgeFacelet[j][0] / 9) {
-                    ccRet.edges[i] = j << 1 | 1;
+                if (c[0] == info::edgeFacelet[j][1] / info::N_PLATES_X_FACE &&
+                    c[1] == info::edgeFacelet[j][0] / info::N_PLATES_X_FACE) {
+                    t.edgeValue[i] = (int8_t) (j << 1 | 1);
                     break;
                 }
             }
         }
+
+        return t;
     }
 
-    //from cube to string
-    std::string CubieCube::toFaceCube(const CubieCube &cc) {
+    /**
+     * The tables of the conversions between facelets and cubies.
+     */
+    static constexpr faceletTables_t FACELETS = faceletTables();
+
+    //from array to cube: one lookup of the colors of every position
+    void CubieCube::toCubieCube(const int8_t f[], CubieCube &ccRet) {
         int8_t i;
-        int8_t j, ori;
-        char f[info::N_PLATES+1];
 
-        char ts[] = {'U', 'R', 'F', 'D', 'L', 'B'};
+        for (i = 0; i < info::NUMBER_CORNER; i++)
+            ccRet.corners[i] = FACELETS.cornerValue[(f[info::cornerFacelet[i][0]] * info::FACES +
+                                                     f[info::cornerFacelet[i][1]]) * info::FACES +
+                                                    f[info::cornerFacelet[i][2]]];
+
+        for (i = 0; i < info::NUMBER_EDGES; i++)
+            ccRet.edges[i] = FACELETS.edgeValue[f[info::edgeFacelet[i][0]] * info::FACES +
+                                                f[info::edgeFacelet[i][1]]];
+    }
+
+    //from string to cube: the colors are the indices of the centers
+    int8_t CubieCube::fromFacelets(const std::string &facelets, CubieCube &ccRet) {
+        char centers[info::FACES];
+        int8_t cube[info::N_PLATES];
+        int32_t count = 0x000000;
+        int8_t i, j;
+        bool notQuit;
+
+        if(facelets.length() != info::N_PLATES)
+            return info::MALFORMED_STRING;
+
+        centers[0] = facelets[info::U5];
+        centers[1] = facelets[info::R5];
+        centers[2] = facelets[info::F5];
+        centers[3] = facelets[info::D5];
+        centers[4] = facelets[info::L5];
+        centers[5] = facelets[info::B5];
+
+        for (i = 0; i < info::N_PLATES; i++) {
+            cube[i] = -1;
+            notQuit = true;
+
+            for(j = 0; notQuit && j < info::FACES; j++){
+                if(centers[j] == facelets[i]){
+                    notQuit = false;
+                    cube[i] = j;
+                }
+            }
+
+            if (cube[i] == -1)
+                return info::MALFORMED_STRING;
+
+            count += 1 << (cube[i] << 2);
+        }
+
+        if (count != 0x999999)
+            return info::MALFORMED_STRING;
+
+        toCubieCube(cube, ccRet);
+
+        return ccRet.check();
+    }
+
+    //from cube to array: the facelets of every value are copied to its position
+    void CubieCube::toFaceCube(const CubieCube &cc, char f[]) {
+        const char* colors;
+        int8_t i;
 
-        for (i = 0; i < info::N_PLATES; i++)
-            f[i] = ts[i / info::N_PLATES_X_FACE];
+        std::memcpy(f, SOLVED_FACELETS, info::N_PLATES);
 
         for (i = 0; i < info::NUMBER_CORNER; i++) {
-            j = cc.corners[i] & 0x7;
-            ori = cc.corners[i] >> 3;
-            for (int8_t n = 0; n < info::CORNE_ORI_CASES; n++) {
-                f[info::cornerFacelet[i][(n + ori) % info::CORNE_ORI_CASES]] = ts[
-                        info::cornerFacelet[j][n] / info::N_PLATES_X_FACE];
-            }
+            colors = FACELETS.cornerColors[cc.corners[i]];
+            f[info::cornerFacelet[i][0]] = colors[0];
+            f[info::cornerFacelet[i][1]] = colors[1];
+            f[info::cornerFacelet[i][2]] = colors[2];
         }
 
         for (i = 0; i < info::NUMBER_EDGES; i++) {
-            j = cc.edges[i] >> 1;
-            ori = cc.edges[i] & 1;
-            for (int8_t n = 0; n < info::EDGE_ORI_CASES; n++) {
-                f[info::edgeFacelet[i][(n + ori) % info::EDGE_ORI_CASES]] = ts[info::edgeFacelet[j][n] /
-                                                                               info::N_PLATES_X_FACE];
-            }
+            colors = FACELETS.edgeColors[cc.edges[i]];
+            f[info::edgeFacelet[i][0]] = colors[0];
+            f[info::edgeFacelet[i][1]] = colors[1];
         }
+    }
 
-        f[info::N_PLATES] = '\0';
+    //from cube to string
+    std::string CubieCube::toFaceCube(const CubieCube &cc) {
+        char f[info::N_PLATES];
+
+        toFaceCube(cc, f);
 
-        return std::string(f);
+        return std::string(f, info::N_PLATES);
     }
 
     // a * b edge only
@@ -244,16 +360,49 @@ namespace min2phase {
 
     }
 
-    //set permutation
+    /**
+     * Reciprocals of the divisors of the digits, from 2 to 12: x / d is
+     * x * RECIPROCAL[d] >> 34, exact for every x < 2^29 (12! is less).
+     */
+    static const uint64_t RECIPROCAL[info::NUMBER_EDGES + 1] = {
+            0, 0, (uint64_t(1) << 34) / 2 + 1, (uint64_t(1) << 34) / 3 + 1, (uint64_t(1) << 34) / 4 + 1,
+            (uint64_t(1) << 34) / 5 + 1, (uint64_t(1) << 34) / 6 + 1, (uint64_t(1) << 34) / 7 + 1,
+            (uint64_t(1) << 34) / 8 + 1, (uint64_t(1) << 34) / 9 + 1, (uint64_t(1) << 34) / 10 + 1,
+            (uint64_t(1) << 34) / 11 + 1, (uint64_t(1) << 34) / 12 + 1
+    };
+
+    //division of a coordinate by a small divisor without the div instruction
+    static inline uint32_t divide(uint32_t x, uint8_t d) {
+        return (uint32_t) (x * RECIPROCAL[d] >> 34);
+    }
+
+    //index of the highest set bit
+    static inline uint8_t highestBit(uint32_t x) {
+#if defined(__GNUC__)
+        return (uint8_t) (31 - __builtin_clz(x));
+#else
+        uint8_t bit = 0;
+
+        while (x >>= 1)
+            bit++;
+
+        return bit;
+#endif
+    }
+
+    //set permutation: the digits are taken with multiplications, then every
+    //digit removes its value from the nibbles of the values left
     void CubieCube::setNPerm(int8_t arr[], int32_t idx, uint8_t n, bool isEdge) {
         uint8_t i;
         uint64_t val = 0xFEDCBA9876543210L;
         int64_t v;
         int64_t m, extract = 0;
+        uint32_t q, x = (uint32_t) idx;
 
         for (i = 2; i <= n; i++) {
-            extract = extract << 4 | idx % i;
-            idx /= i;
+            q = divide(x, i);
+            extract = extract << 4 | (x - q * i);
+            x = q;
         }
 
         for (i = 0; i < n - 1; i++) {
@@ -302,29 +451,34 @@ namespace min2phase {
         }
     }
 
-    //get the parity of corners or edges
+    //get the parity of corners or edges: the positions of the four pieces are
+    //marked in a mask first, then only the four marked positions are visited
     int16_t CubieCube::getComb(const int8_t arr[], uint8_t mask, bool isEdge) {
-        int8_t i, perm, r = 4;
+        uint8_t i, r = 4;
+        uint32_t positions = 0;
         int16_t idxC = 0;
 
-        for (i = isEdge ? info::NUMBER_EDGES - 1 : info::NUMBER_CORNER - 1; i >= 0; i--) {
-            perm = getVal(arr[i], isEdge);
+        for (i = 0; i < (isEdge ? info::NUMBER_EDGES : info::NUMBER_CORNER); i++)
+            positions |= (uint32_t) ((getVal(arr[i], isEdge) & 0xc) == mask) << i;
 
-            if ((perm & 0xc) == mask)
-                idxC += info::Cnk[i][r--];
+        for (; positions != 0; positions &= ~(1u << i)) {
+            i = highestBit(positions);
+            idxC += info::Cnk[i][r--];
         }
 
         return idxC;
     }
 
-    //get the parity permutation
+    //get the parity permutation: the parity of the sum of the digits
     int8_t CubieCube::getNParity(uint32_t idx, uint8_t n) {
-        int8_t i;
+        uint8_t i;
+        uint32_t q;
         int8_t p = 0;
 
-        for (i = n - 2; i >= 0; i--) {
-            p ^= idx % (n - i);
-            idx /= (n - i);
+        for (i = 2; i <= n; i++) {
+            q = divide(idx, i);
+            p ^= idx - q * i;
+            idx = q;
         }
 
         return p & 1;
@@ -454,6 +608,38 @@ namespace min2phase {
         setComb(corners, idx, 0, false);
     }
 
+    //state key: the corner permutation, the twist and the flip in the first
+    //word, the permutation of the 12 edges in the second
+    void CubieCube::getKey(uint64_t key[2]) const {
+        key[0] = (uint64_t) getCPerm() | (uint64_t) getTwist() << 16 | (uint64_t) getFlip() << 28;
+        key[1] = (uint64_t) getNPerm(edges, info::NUMBER_EDGES, true);
+    }
+
+    //finalizer of MurmurHash3: every bit of the input changes half of the output
+    static inline uint64_t mix64(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+
+        return x;
+    }
+
+    //hash of the key, only integer arithmetic so it is the same everywhere
+    uint64_t CubieCube::hashKey(const uint64_t key[2]) {
+        return mix64(key[0] ^ mix64(key[1] + 0x9e3779b97f4a7c15ULL));
+    }
+
+    //hash of the state
+    uint64_t CubieCube::hash() const {
+        uint64_t key[2];
+
+        getKey(key);
+
+        return hashKey(key);
+    }
+
     char constexpr CubieCube::OutputFormat::move2str[info::N_MOVES][3];
 
     //reset output
@@ -101,13 +101,23 @@ namespace min2phase {
 
         /**
          * This function is used to convert an order of face of cube into
-         * a cube object.
+         * a cube object. Every position is one lookup of its colors.
          *
-         * @param f     : the array of the color of the cube to convert.
+         * @param f     : the array of the color of the cube to convert (0 to 5).
          * @param ccRet : the cube to store the new cube created.
          */
         static void toCubieCube(const int8_t f[], CubieCube &ccRet);
 
+        /**
+         * This function is used to convert the facelets of a cube into a
+         * cube object and to check it. The colors are read from the centers.
+         *
+         * @param facelets : the facelets of the cube to convert.
+         * @param ccRet    : the cube to store the new cube created.
+         * @return         : a value that indicates the error, see info.
+         */
+        static int8_t fromFacelets(const std::string &facelets, CubieCube &ccRet);
+
         /**
          * This method is used to convert a cube with coordinates to a string.
          *
@@ -116,6 +126,16 @@ namespace min2phase {
          */
         static std::string toFaceCube(const CubieCube &cc);
 
+        /**
+         * This method is used to convert a cube with coordinates to its
+         * facelets without allocations.
+         *
+         * @param cc : the cube to convert.
+         * @param f  : the buffer for the facelets, N_PLATES chars without
+         *             the terminator.
+         */
+        static void toFaceCube(const CubieCube &cc, char f[]);
+
         /**
          * This method is used to compute the result of a * b edge only.
          *
@@ -379,6 +399,31 @@ namespace min2phase {
          */
         void setCComb(uint8_t idx);
 
+        /**
+         * This method is used to get a key that identifies the state.
+         * The first word has the corner permutation, the twist and the
+         * flip, the second one the permutation of the 12 edges.
+         * Two cubes have the same key only if they have the same state.
+         *
+         * @param key : the array to store the key.
+         */
+        void getKey(uint64_t key[2]) const;
+
+        /**
+         * This function is used to hash a key of a state.
+         * The hash does not depend on the platform.
+         *
+         * @param key : the key of the state.
+         * @return    : the 64 bits hash of the key.
+         */
+        static uint64_t hashKey(const uint64_t key[2]);
+
+        /**
+         * This method is used to get the hash of the state.
+         *
+         * @return : the 64 bits hash of the key of the state.
+         */
+        uint64_t hash() const;
 
         /**
          * This class is used to generate the output string.
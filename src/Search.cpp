@@ -28,6 +28,17 @@ std::string min2phase::Search::solve(const std::string &facelets, int8_t maxDept
     this->probeMin = probeMin;
     this->verbose = verbose;
 
+    //a search can be used again: nothing is kept from the last cube
+    this->conjMask = 0;
+    this->valid1 = 0;
+    this->solution.isFound = false;
+    this->budgetNodes = 0;
+    this->expired = false;
+
+    //a request that waited past its deadline is not searched
+    if (isOver())
+        return std::to_string(info::TIME_LIMIT);
+
     initSearch();
 
     MIN2PHASE_OUTPUT("Search initialized.")
@@ -37,48 +48,55 @@ std::string min2phase::Search::solve(const std::string &facelets, int8_t maxDept
 
 
 int8_t min2phase::Search::verify(const std::string& facelets) {
-    char centers[info::FACES];
-    int8_t cube [info::N_PLATES];
-    int32_t count = 0x000000;
-    int8_t i, j;
-    bool notQuit;
-
-    if(facelets.length() != info::N_PLATES)
-        return info::MALFORMED_STRING;
-
-    centers[0] = facelets[info::U5];
-    centers[1] = facelets[info::R5];
-    centers[2] = facelets[info::F5];
-    centers[3] = facelets[info::D5];
-    centers[4] = facelets[info::L5];
-    centers[5] = facelets[info::B5];
-
-
-    for (i = 0; i < info::N_PLATES; i++) {
-        cube[i] = -1;
-        notQuit = true;
-
-        for(j = 0; notQuit && j < info::FACES; j++){
-            if(centers[j] == facelets[i]){
-                notQuit = false;
-                cube[i] = j;
-            }
-        }
+    const int8_t error = CubieCube::fromFacelets(facelets, solveCube);
 
-        if (cube[i] == -1)
-            return info::MALFORMED_STRING;
-
-        count += 1 << (cube[i] << 2);
+    if (error != info::MALFORMED_STRING) {
+        MIN2PHASE_OUTPUT("Solving a cube.")
     }
 
-    if (count != 0x999999)
-        return info::MALFORMED_STRING;
+    return error;
+}
+
+//budget of the next solves
+void min2phase::Search::setBudget(std::chrono::steady_clock::time_point deadline, const std::atomic<bool>* cancel) {
+    this->deadline = deadline;
+    this->cancel = cancel;
+    this->hasBudget = deadline != std::chrono::steady_clock::time_point::max() || cancel != nullptr;
+}
+
+//stopped by the budget
+bool min2phase::Search::isExpired() const {
+    return expired;
+}
+
+//the clock is read once every BUDGET_NODES nodes
+bool min2phase::Search::isOver() {
+    if (!hasBudget || expired)
+        return expired;
 
-    CubieCube::toCubieCube(cube, solveCube);
+    if (budgetNodes-- != 0)
+        return false;
 
-    MIN2PHASE_OUTPUT("Solving a cube.")
+    budgetNodes = BUDGET_NODES - 1;
+    expired = (cancel != nullptr && cancel->load(std::memory_order_relaxed)) ||
+              std::chrono::steady_clock::now() >= deadline;
 
-    return solveCube.check();
+    return expired;
+}
+
+//probes of the last solve
+int32_t min2phase::Search::getProbes() const {
+    return probe;
+}
+
+//deadline of the budget
+std::chrono::steady_clock::time_point min2phase::Search::getDeadline() const {
+    return deadline;
+}
+
+//flag of the budget
+bool min2phase::Search::isCancelled() const {
+    return cancel != nullptr && cancel->load(std::memory_order_relaxed);
 }
 
 void min2phase::Search::initSearch() {
@@ -89,6 +107,7 @@ void min2phase::Search::initSearch() {
     conjMask |= (selfSym >> 48 & 0xffff) != 0 ? 0x38 : 0;
     selfSym &= 0xffffffffffffL;
     maxPreMoves = conjMask > 7 ? 0 : MAX_PRE_MOVES;
+    useCorner = coords::useCornerPrun();
 
     for (i = 0; i < info::N_BASIC_MOVES; i++) {
         urfCubieCube[i].copy(solveCube);
@@ -102,6 +121,10 @@ void min2phase::Search::initSearch() {
 
 std::string min2phase::Search::search() {
 
+    //the whole solution, pre moves included, must solve the corners
+    if (useCorner && urfCoordCube[0].getPrunCorner() >= solLen)
+        return std::to_string(info::SHORT_DEPTH);
+
     for (length1 = 0; length1 < solLen; length1++) {
         maxDep2 = std::min((int32_t)info::P1_LENGTH, int32_t(solLen - length1 - 1));
 
@@ -112,7 +135,7 @@ std::string min2phase::Search::search() {
 
             if (phase1PreMoves(maxPreMoves, -30, &urfCubieCube[urfIdx], (int32_t)(selfSym & 0xffff)) == 0){
                 if(!solution.isFound)
-                    return std::to_string(info::PROBE_LIMIT);
+                    return std::to_string(expired ? info::TIME_LIMIT : info::PROBE_LIMIT);
 
                 if(movesUsed != nullptr)
                     *movesUsed = solLen;
@@ -191,6 +214,9 @@ int8_t min2phase::Search::phase1(coords::CoordCube* node, uint16_t ssym, int8_t
     MIN2PHASE_OUTPUT("Phase 1.")
 #endif
 
+    if (isOver())
+        return 0;
+
     if (node->prun == 0 && maxl < 5) {
         if (allowShorter || maxl == 0) {
             depth1 -= maxl;
@@ -245,7 +271,7 @@ int8_t min2phase::Search::initPhase2Pre() {
     MIN2PHASE_OUTPUT("Init phase 2.")
 #endif
 
-    if (probe >= (!solution.isFound ? probeMax : probeMin))
+    if (probe >= (!solution.isFound ? probeMax : probeMin) || isOver())
         return 0;
 
     ++probe;
@@ -471,7 +497,8 @@ std::string min2phase::Search::searchOpt() {
     urfIdx = maxprun2 > maxprun1 ? 3 : 0;
     phase1Cubie[0] = urfCubieCube[urfIdx];
 
-    for (length1 = 0; length1 < solLen; length1++) {
+    //no solution is shorter than the corners one
+    for (length1 = useCorner ? urfCoordCube[0].getPrunCorner() : 0; length1 < solLen; length1++) {
         ud = urfCoordCube[0 + urfIdx];
         rl = urfCoordCube[1 + urfIdx];
         fb = urfCoordCube[2 + urfIdx];
@@ -479,7 +506,8 @@ std::string min2phase::Search::searchOpt() {
         if (ud.prun <= length1 && rl.prun <= length1 && fb.prun <= length1
             && phase1opt(ud, rl, fb, selfSym, length1, -1) == 0) {
 
-            return !solution.isFound ? std::to_string(info::PROBE_LIMIT) : solution.toString();
+            return !solution.isFound ? std::to_string(expired ? info::TIME_LIMIT : info::PROBE_LIMIT) :
+                   solution.toString();
         }
     }
 
@@ -487,12 +515,15 @@ std::string min2phase::Search::searchOpt() {
 }
 
 int8_t min2phase::Search::phase1opt(coords::CoordCube ud, coords::CoordCube rl, coords::CoordCube fb, int64_t ssym, int8_t maxl, int8_t lm) {
-    uint8_t axis, power, prun_ud, prun_rl, prun_fb, m;
+    uint8_t axis, power, prun_ud, prun_rl, prun_fb, prun_corner, m;
 
 #if MIN2PHASE_DEBUG > 1
     MIN2PHASE_OUTPUT("Phase 1 optimal.")
 #endif
 
+    if (isOver())
+        return 0;
+
     if (ud.prun == 0 && rl.prun == 0 && fb.prun == 0 && maxl < 5) {
         maxDep2 = maxl;
         depth1 = length1 - maxl;
@@ -514,6 +545,16 @@ int8_t min2phase::Search::phase1opt(coords::CoordCube ud, coords::CoordCube rl,
             else if (prun_ud == maxl)
                 continue;
 
+            // Corners
+            if (useCorner) {
+                prun_corner = nodeUD[maxl].doMovePrunCorner(ud, m);
+
+                if (prun_corner > maxl)
+                    break;
+                else if (prun_corner == maxl)
+                    continue;
+            }
+
             // RL Axis
             m = info::urfMove[2][m];
 
@@ -8,6 +8,8 @@
 #ifndef MIN2PHASE_SEARCH_H
 #define MIN2PHASE_SEARCH_H 1
 
+#include <atomic>
+#include <chrono>
 #include "coords.h"
 
 namespace min2phase {
@@ -18,6 +20,11 @@ namespace min2phase {
         static const int8_t MAX_PRE_MOVES = 20;
         static const int8_t MIN_P1LENGTH_PRE = 7;
 
+        /**
+         * The nodes of the search between two checks of the budget.
+         */
+        static const uint16_t BUDGET_NODES = 1024;
+
         coords::CoordCube nodeUD[MAX_PRE_MOVES + 1]{};
         coords::CoordCube nodeRL[MAX_PRE_MOVES + 1]{};
         coords::CoordCube nodeFB[MAX_PRE_MOVES + 1]{};
@@ -50,6 +57,13 @@ namespace min2phase {
         int8_t maxPreMoves = 0;
 
         bool allowShorter = false;
+        bool useCorner = false;
+
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+        const std::atomic<bool>* cancel = nullptr;
+        uint16_t budgetNodes = 0;
+        bool hasBudget = false;
+        bool expired = false;
 
     public:
 
@@ -104,7 +118,48 @@ namespace min2phase {
 
         int8_t verify(const std::string &facelets);
 
+        /**
+         * Set the budget of the next solves: a search stops at the deadline
+         * or when the flag is set, with the best solution found so far or
+         * with the error TIME_LIMIT if there is none.
+         *
+         * @param deadline : the time the searches stop, the max time for none.
+         * @param cancel   : the flag that stops the searches, nullptr for none.
+         */
+        void setBudget(std::chrono::steady_clock::time_point deadline, const std::atomic<bool>* cancel);
+
+        /**
+         * Tell if the last solve was stopped by its budget.
+         *
+         * @return         : true if the deadline or the flag stopped it.
+         */
+        bool isExpired() const;
+
+        /**
+         * Get the number of cubes explored in phase 2 by the last solve.
+         *
+         * @return         : the probes of the last solve.
+         */
+        int32_t getProbes() const;
+
+        /**
+         * Get the deadline of the budget, for a solve that waits for another
+         * search instead of searching.
+         *
+         * @return         : the deadline, the max time for none.
+         */
+        std::chrono::steady_clock::time_point getDeadline() const;
+
+        /**
+         * Tell if the flag of the budget is set.
+         *
+         * @return         : true if the searches must stop.
+         */
+        bool isCancelled() const;
+
     private:
+        bool isOver();
+
         void initSearch();
 
         std::string search();
@@ -0,0 +1,146 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include "binary.h"
+#include "CubieCube.h"
+#include "info.h"
+
+namespace min2phase { namespace binary {
+
+    //write a number, the low byte first
+    static void put(std::string& output, uint64_t value, uint8_t bytes) {
+        for (uint8_t i = 0; i < bytes; i++)
+            output += (char) (value >> 8 * i & 0xff);
+    }
+
+    //read a number, the low byte first
+    static uint64_t get(const std::string& input, size_t pos, uint8_t bytes) {
+        uint64_t value = 0;
+
+        for (uint8_t i = 0; i < bytes; i++)
+            value |= (uint64_t) (uint8_t) input[pos + i] << 8 * i;
+
+        return value;
+    }
+
+    //frame of a request
+    void writeRequest(const request_t& request, std::string& output) {
+        put(output, REQUEST_SIZE - 4, 4);
+        put(output, request.id, 4);
+        put(output, (uint8_t) request.maxDepth, 1);
+        put(output, (uint8_t) request.verbose, 1);
+        put(output, 0, 2);
+        put(output, (uint32_t) request.probeMax, 4);
+        put(output, (uint32_t) request.probeMin, 4);
+        put(output, request.timeout, 4);
+        put(output, request.key[0], 8);
+        put(output, request.key[1], 8);
+    }
+
+    //request at the start of the input
+    size_t readRequest(const std::string& input, size_t start, request_t& request) {
+        if (input.length() - start < 4)
+            return 0;
+
+        if (get(input, start, 4) != REQUEST_SIZE - 4)
+            return SIZE_MAX;
+
+        if (input.length() - start < REQUEST_SIZE)
+            return 0;
+
+        request.id = (uint32_t) get(input, start + 4, 4);
+        request.maxDepth = (int8_t) get(input, start + 8, 1);
+        request.verbose = (int8_t) get(input, start + 9, 1);
+        request.probeMax = (int32_t) get(input, start + 12, 4);
+        request.probeMin = (int32_t) get(input, start + 16, 4);
+        request.timeout = (uint32_t) get(input, start + 20, 4);
+        request.key[0] = get(input, start + 24, 8);
+        request.key[1] = get(input, start + 32, 8);
+
+        return REQUEST_SIZE;
+    }
+
+    //frame of a response
+    void writeResponse(uint32_t id, const RemoteSolution& solution, std::string& output) {
+        put(output, RESPONSE_HEAD - 4 + solution.length, 4);
+        put(output, id, 4);
+        put(output, (uint8_t) solution.error, 1);
+        put(output, solution.length, 1);
+        output.append((const char*) solution.moves, solution.length);
+    }
+
+    //response at the start of the input
+    size_t readResponse(const std::string& input, size_t start, uint32_t& id, RemoteSolution& solution) {
+        size_t length;
+
+        if (input.length() - start < 4)
+            return 0;
+
+        length = (size_t) get(input, start, 4);
+
+        if (length < RESPONSE_HEAD - 4 || length > RESPONSE_HEAD - 4 + sizeof(solution.moves))
+            return SIZE_MAX;
+
+        if (input.length() - start < length + 4)
+            return 0;
+
+        id = (uint32_t) get(input, start + 4, 4);
+        solution.error = (int8_t) get(input, start + 8, 1);
+        solution.length = (uint8_t) get(input, start + 9, 1);
+
+        if (solution.length != length + 4 - RESPONSE_HEAD)
+            return SIZE_MAX;
+
+        std::memcpy(solution.moves, input.data() + start + RESPONSE_HEAD, solution.length);
+
+        return length + 4;
+    }
+
+    //cube of the key, the inverse of CubieCube::getKey
+    bool toFacelets(const uint64_t key[2], std::string& facelets) {
+        const uint64_t cPerm = key[0] & 0xffff, twist = key[0] >> 16 & 0xfff, flip = key[0] >> 28;
+
+        if (cPerm >= info::N_PERM || twist >= info::N_TWIST || flip >= info::N_FLIP || key[1] >= info::FULL_E_PERM)
+            return false;
+
+        facelets = CubieCube::toFaceCube(CubieCube((uint16_t) cPerm, (int16_t) twist, (int32_t) key[1],
+                                                   (int16_t) flip));
+
+        return true;
+    }
+
+    //moves of a solution: a face and a power each, the errors are numbers
+    void toMoves(const std::string& text, RemoteSolution& solution) {
+        static const char FACES[] = "URFDLB";
+        const char* face;
+
+        solution.error = info::NO_ERROR;
+        solution.length = 0;
+
+        if (!text.empty() && text[0] >= '0' && text[0] <= '9') {
+            solution.error = (int8_t) std::atoi(text.c_str());
+            return;
+        }
+
+        for (size_t i = 0; i < text.length(); i++) {
+            if (text[i] == ' ' || (face = std::strchr(FACES, text[i])) == nullptr || *face == '\0' ||
+                solution.length == info::MAX_LENGTH)
+                continue;
+
+            solution.moves[solution.length] = (int8_t) ((face - FACES) * 3);
+
+            if (i + 1 < text.length() && text[i + 1] == '2')
+                solution.moves[solution.length] += 1;
+            else if (i + 1 < text.length() && text[i + 1] == '\'')
+                solution.moves[solution.length] += 2;
+
+            solution.length++;
+        }
+    }
+} }
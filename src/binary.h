@@ -0,0 +1,121 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the binary protocol of the server, for the clients on
+ * the same machine or the same network that do not need HTTP. Every frame
+ * starts with its length (4 bytes) and all the numbers are little endian.
+ *
+ * Request, 40 bytes:
+ *   u32 length (36), u32 id, u8 maxDepth, u8 verbose, u16 0,
+ *   u32 probeMax, u32 probeMin, u32 timeout (ms, 0 for the default),
+ *   u64 key[0], u64 key[1] (the key of the state, see tools::stateKey).
+ *
+ * Response, 10 bytes and the moves:
+ *   u32 length (6 + n), u32 id, i8 status, u8 n, u8 moves[n].
+ *
+ * The status is 0 for a solution, the error of the solve (see the errors of
+ * the search) or BUSY and MALFORMED. The moves go from 0 to 17 in the order
+ * U U2 U' R R2 R' F F2 F' D D2 D' L L2 L' B B2 B'. The responses come in the
+ * order of the requests, the id is the one of the request.
+ */
+
+#ifndef MIN2PHASE_BINARY_H
+#define MIN2PHASE_BINARY_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <min2phase/min2phase.h>
+
+namespace min2phase { namespace binary {
+
+    /**
+     * The bytes of a request and of the head of a response, with their
+     * length.
+     */
+    const uint32_t REQUEST_SIZE = 40;
+    const uint32_t RESPONSE_HEAD = 10;
+
+    /**
+     * The status of a request refused because the queue of the server is
+     * full and of a request that has no valid key.
+     */
+    const int8_t BUSY = 64;
+    const int8_t MALFORMED = 65;
+
+    /**
+     * A request of the protocol.
+     */
+    typedef struct request_s {
+        uint32_t id;
+        int8_t maxDepth;
+        int8_t verbose;
+        int32_t probeMax;
+        int32_t probeMin;
+        uint32_t timeout;
+        uint64_t key[2];
+    }request_t;
+
+    /**
+     * Append a request to a buffer.
+     *
+     * @param request   : the request.
+     * @param output    : the buffer.
+     */
+    void writeRequest(const request_t& request, std::string& output);
+
+    /**
+     * Read the request at the start of the input.
+     *
+     * @param input     : the bytes read.
+     * @param start     : where the request starts.
+     * @param request   : where to store the request.
+     * @return          : the bytes of the request, 0 if it is not complete
+     *                    yet, SIZE_MAX if its length is wrong: the stream
+     *                    can not be read anymore.
+     */
+    size_t readRequest(const std::string& input, size_t start, request_t& request);
+
+    /**
+     * Append a response to a buffer.
+     *
+     * @param id        : the id of the request.
+     * @param solution  : the solution.
+     * @param output    : the buffer.
+     */
+    void writeResponse(uint32_t id, const RemoteSolution& solution, std::string& output);
+
+    /**
+     * Read the response at the start of the input.
+     *
+     * @param input     : the bytes read.
+     * @param start     : where the response starts.
+     * @param id        : where to store the id of the request.
+     * @param solution  : where to store the solution.
+     * @return          : the bytes of the response, 0 if it is not complete
+     *                    yet, SIZE_MAX if its length is wrong.
+     */
+    size_t readResponse(const std::string& input, size_t start, uint32_t& id, RemoteSolution& solution);
+
+    /**
+     * Get the cube of a key of a state.
+     *
+     * @param key       : the key, see tools::stateKey.
+     * @param facelets  : where to store the cube.
+     * @return          : false if a coordinate of the key is out of its range.
+     */
+    bool toFacelets(const uint64_t key[2], std::string& facelets);
+
+    /**
+     * Convert a solution of the search to its moves, or to its error.
+     *
+     * @param text      : the solution, without separator and length.
+     * @param solution  : where to store the moves.
+     */
+    void toMoves(const std::string& text, RemoteSolution& solution);
+} }
+
+#endif //MIN2PHASE_BINARY_H
@@ -0,0 +1,310 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <min2phase/tools.h>
+#include "cache.h"
+#include "info.h"
+#include "metrics.h"
+
+namespace min2phase { namespace cache {
+
+    /**
+     * The number of shards, a power of two: a shard is chosen by the top
+     * bits of the hash.
+     */
+    static const uint8_t N_SHARDS = 16;
+    static const uint8_t SHARD_BITS = 4;
+
+    /**
+     * The bytes of an entry that are not in the entry: the nodes of the
+     * list and of the map and the bucket.
+     */
+    static const size_t ENTRY_OVERHEAD = 64;
+
+    /**
+     * How often a request that waits for the same search looks at its
+     * cancel flag, in milliseconds.
+     */
+    static const uint16_t CANCEL_POLL_MS = 10;
+
+    /**
+     * The key of a solution: the state of the cube and the parameters of
+     * the solve, with the hash of all of them.
+     */
+    typedef struct solveKey_s {
+        uint64_t state[2];
+        int32_t probeMax;
+        int32_t probeMin;
+        int8_t maxDepth;
+        int8_t verbose;
+        uint64_t hash;
+    }solveKey_t;
+
+    /**
+     * The hash and the equality of the keys for the maps.
+     */
+    typedef struct keyHash_s {
+        size_t operator()(const solveKey_t& key) const {
+            return (size_t) key.hash;
+        }
+    }keyHash_t;
+
+    typedef struct keyEqual_s {
+        bool operator()(const solveKey_t& a, const solveKey_t& b) const {
+            return a.state[0] == b.state[0] && a.state[1] == b.state[1] && a.probeMax == b.probeMax &&
+                   a.probeMin == b.probeMin && a.maxDepth == b.maxDepth && a.verbose == b.verbose;
+        }
+    }keyEqual_t;
+
+    /**
+     * A cached solution.
+     */
+    typedef struct entry_s {
+        solveKey_t key;
+        std::string solution;
+        uint8_t usedMoves;
+    }entry_t;
+
+    /**
+     * A search in progress: the requests of the same key wait for it and
+     * take its solution, or search again if its budget stopped it.
+     */
+    typedef struct flight_s {
+        std::condition_variable ready;
+        std::string solution;
+        uint8_t usedMoves;
+        bool done;
+        bool expired;
+    }flight_t;
+
+    /**
+     * A shard: the entries from the most recently used, their index, the
+     * searches in progress and the counters, all under the lock of the
+     * shard.
+     */
+    typedef struct alignas(64) shard_s {
+        std::mutex lock;
+        std::list<entry_t> entries;
+        std::unordered_map<solveKey_t, std::list<entry_t>::iterator, keyHash_t, keyEqual_t> index;
+        std::unordered_map<solveKey_t, std::shared_ptr<flight_t>, keyHash_t, keyEqual_t> flights;
+        size_t bytes;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t coalesced;
+        uint64_t evictions;
+    }shard_t;
+
+    static shard_t shards[N_SHARDS];
+
+    /**
+     * The limit of the bytes of the cache, every shard takes its share.
+     */
+    static std::atomic<size_t> limit(DEFAULT_LIMIT);
+
+    //bytes of an entry
+    static size_t entryBytes(const entry_t& entry) {
+        return sizeof(entry_t) + ENTRY_OVERHEAD + entry.solution.capacity();
+    }
+
+    //remove the least recently used entries over the share of the shard
+    static void evict(shard_t& shard, size_t share) {
+        while (shard.bytes > share && !shard.entries.empty()) {
+            shard.bytes -= entryBytes(shard.entries.back());
+            shard.index.erase(shard.entries.back().key);
+            shard.entries.pop_back();
+            shard.evictions++;
+        }
+    }
+
+    //the key of a solve, false if the cube is not valid
+    static bool makeKey(const std::string& facelets, int8_t maxDepth, int32_t probeMax, int32_t probeMin,
+                        int8_t verbose, solveKey_t& key) {
+        if (!tools::stateKey(facelets, key.state))
+            return false;
+
+        key.probeMax = probeMax;
+        key.probeMin = probeMin;
+        key.maxDepth = maxDepth;
+        key.verbose = verbose;
+        key.hash = tools::stateHash(key.state) ^
+                   ((uint64_t) (uint32_t) probeMax << 32 | (uint32_t) probeMin) * 0x9e3779b97f4a7c15ULL ^
+                   ((uint64_t) (uint8_t) maxDepth << 8 | (uint8_t) verbose) * 0xc2b2ae3d27d4eb4fULL;
+
+        return true;
+    }
+
+    //look in the cache, then wait for the same search, then solve and keep the solution
+    static std::string find(Search& search, const solveKey_t& key, const std::string& facelets, uint8_t& usedMoves) {
+        const size_t share = limit / N_SHARDS;
+        shard_t& shard = shards[key.hash >> (64 - SHARD_BITS)];
+        std::shared_ptr<flight_t> flight;
+        entry_t entry;
+
+        {
+            std::unique_lock<std::mutex> lock(shard.lock);
+
+            while (true) {
+                auto found = shard.index.find(key);
+                auto inFlight = shard.flights.find(key);
+
+                if (found != shard.index.end()) {
+                    shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+                    shard.hits++;
+                    usedMoves = found->second->usedMoves;
+
+                    return found->second->solution;
+                }
+
+                if (inFlight == shard.flights.end())
+                    break;
+
+                //the same cube is being solved: its search is shared, the wait stops at the budget of this request
+                flight = inFlight->second;
+                shard.coalesced++;
+
+                while (!flight->done) {
+                    const auto now = std::chrono::steady_clock::now();
+
+                    if (search.isCancelled() || now >= search.getDeadline()) {
+                        usedMoves = 0;
+                        return std::to_string(info::TIME_LIMIT);
+                    }
+
+                    flight->ready.wait_until(lock, std::min(search.getDeadline(),
+                                                            now + std::chrono::milliseconds(CANCEL_POLL_MS)));
+                }
+
+                if (!flight->expired) {
+                    usedMoves = flight->usedMoves;
+                    return flight->solution;
+                }
+            }
+
+            shard.misses++;
+            flight = std::make_shared<flight_t>();
+            shard.flights.emplace(key, flight);
+        }
+
+        flight->usedMoves = 0;
+        flight->solution = search.solve(facelets, key.maxDepth, key.probeMax, key.probeMin, key.verbose,
+                                        &flight->usedMoves);
+        flight->expired = search.isExpired();
+        usedMoves = flight->usedMoves;
+        metrics::search((uint64_t) search.getProbes(), flight->expired);
+
+        {
+            std::lock_guard<std::mutex> lock(shard.lock);
+
+            //a search stopped by its budget is not the solution of the key
+            if (share > 0 && !flight->expired) {
+                entry.key = key;
+                entry.solution = flight->solution;
+                entry.usedMoves = flight->usedMoves;
+
+                shard.bytes += entryBytes(entry);
+                shard.entries.push_front(std::move(entry));
+                shard.index.emplace(key, shard.entries.begin());
+                evict(shard, share);
+            }
+
+            flight->done = true;
+            shard.flights.erase(key);
+        }
+
+        flight->ready.notify_all();
+
+        return flight->solution;
+    }
+
+    //solve a valid cube through the cache and count it in the metrics
+    std::string solve(Search& search, const std::string& facelets, int8_t maxDepth, int32_t probeMax,
+                      int32_t probeMin, int8_t verbose, uint8_t* usedMoves) {
+        const auto start = std::chrono::steady_clock::now();
+        std::string solution;
+        uint8_t moves = 0;
+        solveKey_t key;
+
+        if (!makeKey(facelets, maxDepth, probeMax, probeMin, verbose, key))
+            return search.solve(facelets, maxDepth, probeMax, probeMin, verbose, usedMoves);
+
+        solution = find(search, key, facelets, moves);
+        metrics::solve((uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count(), moves);
+
+        if (usedMoves != nullptr)
+            *usedMoves = moves;
+
+        return solution;
+    }
+
+    //set the limit, the shards over it are trimmed now
+    void setLimit(size_t bytes) {
+        limit = bytes;
+
+        for (shard_t& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            evict(shard, bytes / N_SHARDS);
+        }
+    }
+
+    //remove the entries
+    void clear() {
+        for (shard_t& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.lock);
+
+            shard.entries.clear();
+            shard.index.clear();
+            shard.bytes = 0;
+            shard.hits = 0;
+            shard.misses = 0;
+            shard.coalesced = 0;
+            shard.evictions = 0;
+        }
+    }
+
+    //sum of the shards
+    counters_t counters() {
+        counters_t total = {0, 0, limit.load(), 0, 0, 0, 0};
+
+        for (shard_t& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.lock);
+
+            total.entries += shard.entries.size();
+            total.bytes += shard.bytes;
+            total.hits += shard.hits;
+            total.misses += shard.misses;
+            total.coalesced += shard.coalesced;
+            total.evictions += shard.evictions;
+        }
+
+        return total;
+    }
+
+    //the counters in a line
+    std::string stats() {
+        const counters_t total = counters();
+        char line[256];
+
+        std::snprintf(line, sizeof(line), "cache: %zu solutions, %zu of %zu bytes, %llu hits, %llu misses "
+                                          "(%.2f%% hits), %llu coalesced, %llu evictions\n",
+                      total.entries, total.bytes, total.limit, (unsigned long long) total.hits,
+                      (unsigned long long) total.misses, total.hits + total.misses == 0 ? 0.0 :
+                      100.0 * total.hits / (total.hits + total.misses), (unsigned long long) total.coalesced,
+                      (unsigned long long) total.evictions);
+
+        return line;
+    }
+} }
@@ -0,0 +1,97 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the cache of the solutions of the server. A solution
+ * is kept by the state of the cube, so the same cube with other colors is
+ * the same entry, and by the parameters of the solve: the search finds the
+ * same solution every time. The cache is split in shards, each one with
+ * its lock and its least recently used list, and the entries are removed
+ * from the oldest when the shard is over its share of the bytes. The
+ * requests of a cube that is being solved wait for that search and take its
+ * solution, also when the cache is off.
+ */
+
+#ifndef MIN2PHASE_CACHE_H
+#define MIN2PHASE_CACHE_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Search.h"
+
+namespace min2phase { namespace cache {
+
+    /**
+     * The bytes of the cache when the server starts.
+     */
+    const size_t DEFAULT_LIMIT = 64 << 20;
+
+    /**
+     * The counters of the cache.
+     */
+    typedef struct counters_s {
+        size_t entries;
+        size_t bytes;
+        size_t limit;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t coalesced;
+        uint64_t evictions;
+    }counters_t;
+
+    /**
+     * Solve a cube, or take its solution from the cache, or wait for the
+     * search of the same solve that is running. The cubes that are not
+     * valid are solved every time, and a search stopped by its budget (see
+     * Search::setBudget) is not kept. The wait for another search stops at
+     * the budget of the search given, with the error TIME_LIMIT. It is
+     * thread safe.
+     *
+     * @see: Search::solve
+     *
+     * @param search    : the search used if the solution is not cached.
+     * @param facelets  : the cube.
+     * @param maxDepth  : the max of moves used to solve the cube.
+     * @param probeMax  : the max of cube explored in phase 2.
+     * @param probeMin  : the min of cube explored in phase 2.
+     * @param verbose   : the format for the output strings.
+     * @param usedMoves : (Optional) the pointer to store the number of moves used.
+     * @return          : the solution.
+     */
+    std::string solve(Search& search, const std::string& facelets, int8_t maxDepth, int32_t probeMax,
+                      int32_t probeMin, int8_t verbose, uint8_t* usedMoves);
+
+    /**
+     * Set the bytes of the cache and remove the entries over them, 0 turns
+     * the cache off. It is thread safe.
+     *
+     * @param bytes     : the limit of the memory of the entries.
+     */
+    void setLimit(size_t bytes);
+
+    /**
+     * Remove every entry and reset the counters.
+     */
+    void clear();
+
+    /**
+     * Get the counters of the cache, the sum of the shards.
+     *
+     * @return          : the counters.
+     */
+    counters_t counters();
+
+    /**
+     * Get the state of the cache: the entries, the bytes, the hits, the
+     * misses, the requests that waited for a running search and the
+     * entries removed to stay in the limit.
+     *
+     * @return          : the stats in a line.
+     */
+    std::string stats();
+} }
+
+#endif //MIN2PHASE_CACHE_H
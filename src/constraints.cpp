@@ -0,0 +1,374 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "constraints.h"
+
+namespace min2phase { namespace constraints {
+
+    /**
+     * The names of the properties in the rules.
+     */
+    static const char* const NAMES[N_PROPERTIES] = {
+            "corner-targets", "corner-cycles", "twists", "edge-targets", "edge-cycles", "flips", "parity-target"
+    };
+
+    /**
+     * The highest value of every property, one target per piece and one
+     * more per cycle break.
+     */
+    static const int8_t MAX_VALUES[N_PROPERTIES] = {
+            info::NUMBER_CORNER - 1 + 3, info::NUMBER_CORNER / 2, info::NUMBER_CORNER - 1,
+            info::NUMBER_EDGES - 1 + 5, info::NUMBER_EDGES / 2, info::NUMBER_EDGES - 1, 'X'
+    };
+
+    /**
+     * The buffers: URF and UF.
+     */
+    static const int8_t CORNER_BUFFER = 0;
+    static const int8_t EDGE_BUFFER = 1;
+
+    /**
+     * The edges in the order of the cycle breaks: UB, UR, UF, UL, FR, FL,
+     * BR, BL, DF, DR, DB, DL.
+     */
+    static const int8_t EDGE_ORDER[info::NUMBER_EDGES] = {3, 0, 1, 2, 8, 9, 11, 10, 5, 4, 7, 6};
+
+    /**
+     * The place of every edge in the order of the cycle breaks.
+     */
+    static const int8_t EDGE_RANK[info::NUMBER_EDGES] = {1, 2, 3, 0, 9, 8, 11, 10, 4, 5, 7, 6};
+
+    /**
+     * The first Speffz letter of every face, in the order of the facelets.
+     */
+    static const char FACE_LETTER[] = "AMIUEQ";
+
+    /**
+     * The Speffz letters of the edges, in the order of the cycle breaks.
+     */
+    typedef struct edgeLetters_s {
+        char letter[info::NUMBER_EDGES][info::EDGE_ORI_CASES];
+    }edgeLetters_t;
+
+    /**
+     * Build the Speffz letters of the edges from their facelets: the edges of
+     * a face are lettered from the top one clockwise.
+     *
+     * @return  : the letters.
+     */
+    static constexpr edgeLetters_t edgeLetters() {
+        edgeLetters_t t{};
+        int8_t i = 0, j = 0, facelet = 0;
+
+        for (i = 0; i < info::NUMBER_EDGES; i++) {
+            for (j = 0; j < info::EDGE_ORI_CASES; j++) {
+                facelet = info::edgeFacelet[EDGE_ORDER[i]][j];
+                t.letter[i][j] = (char) (FACE_LETTER[facelet / 9] + (facelet % 9 == 1 ? 0 : facelet % 9 == 5 ? 1 :
+                                                                     facelet % 9 == 7 ? 2 : 3));
+            }
+        }
+
+        return t;
+    }
+
+    /**
+     * The Speffz letters of the edges.
+     */
+    static constexpr edgeLetters_t LETTERS = edgeLetters();
+
+    /**
+     * A compiled rule with its counters.
+     */
+    typedef struct constraint_s {
+        Property property;
+        int8_t min;
+        int8_t max;
+        uint64_t checked;
+        uint64_t accepted;
+    }constraint_t;
+
+    /**
+     * The trace of a corner permutation.
+     */
+    typedef struct cornerTrace_s {
+        int8_t targets;
+        int8_t cycles;
+    }cornerTrace_t;
+
+    /**
+     * The properties of the edges of a cube.
+     */
+    typedef struct edgeTrace_s {
+        int8_t targets;
+        int8_t cycles;
+        int8_t flips;
+        char last;
+    }edgeTrace_t;
+
+    /**
+     * The constraints, in the order of the rules.
+     */
+    static std::vector<constraint_t> rules;
+
+    /**
+     * The trace of every corner permutation, built with the first rule on
+     * the corner permutation.
+     */
+    static std::vector<cornerTrace_t> cornerTable;
+
+    /**
+     * Fill the table of the corner permutations: the cycle of the buffer
+     * takes one target less than its length, the others one more.
+     */
+    static void buildCornerTable() {
+        CubieCube cube;
+        bool visited[info::NUMBER_CORNER];
+        int8_t i, j, length;
+        bool buffer;
+
+        cornerTable.resize(info::N_PERM);
+
+        for (uint16_t perm = 0; perm < info::N_PERM; perm++) {
+            cube.setCPerm(perm);
+            std::memset(visited, 0, sizeof(visited));
+            cornerTable[perm] = {0, 0};
+
+            for (i = 0; i < info::NUMBER_CORNER; i++) {
+                if (visited[i] || (cube.corners[i] & 0x7) == i)
+                    continue;
+
+                for (length = 0, buffer = false, j = i; !visited[j]; j = cube.corners[j] & 0x7, length++) {
+                    visited[j] = true;
+                    buffer |= j == CORNER_BUFFER;
+                }
+
+                cornerTable[perm].targets += buffer ? length - 1 : length + 1;
+                cornerTable[perm].cycles++;
+            }
+        }
+    }
+
+    /**
+     * Trace the edges from the buffer, the solved buffer breaks into the
+     * first unsolved edge. It follows the trace of the sticker cube.
+     *
+     * @param cube  : the cube.
+     * @param trace : the properties of the edges.
+     */
+    static void traceEdges(const CubieCube& cube, edgeTrace_t& trace) {
+        const int8_t buffer = EDGE_RANK[EDGE_BUFFER];
+        int8_t p[info::NUMBER_EDGES], o[info::NUMBER_EDGES];
+        bool visited[info::NUMBER_EDGES] = {};
+        int8_t held, heldOri, piece, pieceOri, place, slot, i, j, unsolved = 0;
+
+        for (i = 0; i < info::NUMBER_EDGES; i++) {
+            p[i] = EDGE_RANK[cube.edges[EDGE_ORDER[i]] >> 1];
+            o[i] = (int8_t) (cube.edges[EDGE_ORDER[i]] & 1);
+        }
+
+        trace = {0, 0, 0, 0};
+
+        for (i = 0; i < info::NUMBER_EDGES; i++) {
+            if (!visited[i] && p[i] != i) {
+                trace.cycles++;
+                for (j = i; !visited[j]; j = p[j])
+                    visited[j] = true;
+            }
+        }
+
+        //the edge at the buffer is kept out of the arrays until the end
+        held = p[buffer];
+        heldOri = o[buffer];
+
+        while (true) {
+            if (held == buffer) {
+                while (unsolved < info::NUMBER_EDGES && (unsolved == buffer || p[unsolved] == unsolved))
+                    unsolved++;
+
+                if (unsolved == info::NUMBER_EDGES)
+                    break;
+
+                place = unsolved;
+                slot = 0;
+            } else {
+                place = held;
+                slot = heldOri;
+            }
+
+            trace.last = LETTERS.letter[place][slot];
+            trace.targets++;
+
+            piece = p[place];
+            pieceOri = o[place];
+            p[place] = held;
+            o[place] = (int8_t) (slot ^ heldOri);
+            held = piece;
+            heldOri = (int8_t) (pieceOri ^ slot);
+        }
+
+        for (i = 0; i < info::NUMBER_EDGES; i++)
+            trace.flips += i != buffer && o[i] != 0;
+    }
+
+    /**
+     * Check a value against a rule and count it.
+     *
+     * @param rule  : the rule.
+     * @param value : the value of the property.
+     * @return      : true if the value is in the range of the rule.
+     */
+    static bool check(constraint_t& rule, int8_t value) {
+        rule.checked++;
+
+        if (value < rule.min || value > rule.max)
+            return false;
+
+        rule.accepted++;
+
+        return true;
+    }
+
+    //compile a rule
+    bool add(const std::string& rule) {
+        const size_t equal = rule.find('=');
+        const std::string name = rule.substr(0, equal), value = equal == std::string::npos ? "" : rule.substr(equal + 1);
+        constraint_t c{N_PROPERTIES, 0, 0, 0, 0};
+        const char* text;
+        char* end;
+        long min, max;
+        int8_t i;
+
+        for (i = 0; i < N_PROPERTIES; i++) {
+            if (name == NAMES[i])
+                c.property = (Property) i;
+        }
+
+        if (c.property == N_PROPERTIES || value.empty())
+            return false;
+
+        if (c.property == PARITY_TARGET) {
+            //the stickers of the buffer are never targets
+            if (value.size() != 1 || value[0] < 'A' || value[0] > MAX_VALUES[PARITY_TARGET] ||
+                value[0] == LETTERS.letter[EDGE_RANK[EDGE_BUFFER]][0] || value[0] == LETTERS.letter[EDGE_RANK[EDGE_BUFFER]][1])
+                return false;
+
+            c.min = c.max = value[0];
+        } else {
+            text = value.c_str();
+            min = std::strtol(text, &end, 10);
+            if (end == text)
+                return false;
+
+            max = min;
+            if (*end == '-') {
+                text = end + 1;
+                max = std::strtol(text, &end, 10);
+                if (end == text)
+                    return false;
+            }
+
+            if (*end != '\0' || min < 0 || min > max || max > MAX_VALUES[c.property])
+                return false;
+
+            c.min = (int8_t) min;
+            c.max = (int8_t) max;
+        }
+
+        if ((c.property == CORNER_TARGETS || c.property == CORNER_CYCLES) && cornerTable.empty())
+            buildCornerTable();
+
+        rules.push_back(c);
+
+        return true;
+    }
+
+    //remove the rules
+    void clear() {
+        rules.clear();
+    }
+
+    //check the corners, the permutation is read from the table
+    bool acceptCorners(const CubieCube& cube, uint16_t cPerm) {
+        int8_t twists = -1, i;
+
+        for (constraint_t& rule : rules) {
+            switch (rule.property) {
+                case CORNER_TARGETS:
+                    if (!check(rule, cornerTable[cPerm].targets))
+                        return false;
+                    break;
+                case CORNER_CYCLES:
+                    if (!check(rule, cornerTable[cPerm].cycles))
+                        return false;
+                    break;
+                case TWISTS:
+                    if (twists < 0) {
+                        for (twists = 0, i = 0; i < info::NUMBER_CORNER; i++)
+                            twists += i != CORNER_BUFFER && (cube.corners[i] & 0x7) == i &&
+                                      cube.corners[i] >> info::CORNE_ORI_CASES != 0;
+                    }
+                    if (!check(rule, twists))
+                        return false;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        return true;
+    }
+
+    //check the edges, they are traced once for all the rules
+    bool acceptEdges(const CubieCube& cube) {
+        edgeTrace_t trace{};
+        bool traced = false;
+        int8_t value;
+
+        for (constraint_t& rule : rules) {
+            if (rule.property < EDGE_TARGETS)
+                continue;
+
+            if (!traced) {
+                traceEdges(cube, trace);
+                traced = true;
+            }
+
+            value = rule.property == EDGE_TARGETS ? trace.targets : rule.property == EDGE_CYCLES ? trace.cycles :
+                    rule.property == FLIPS ? trace.flips : (int8_t) trace.last;
+
+            if (!check(rule, value))
+                return false;
+        }
+
+        return true;
+    }
+
+    //acceptance rate of every rule
+    std::string report() {
+        std::string text;
+        char line[128];
+
+        for (const constraint_t& rule : rules) {
+            if (rule.property == PARITY_TARGET)
+                std::snprintf(line, sizeof(line), "%s=%c", NAMES[rule.property], rule.min);
+            else
+                std::snprintf(line, sizeof(line), "%s=%d-%d", NAMES[rule.property], rule.min, rule.max);
+
+            text += line;
+            std::snprintf(line, sizeof(line), ": %llu of %llu cubes accepted (%.2f%%)\n",
+                          (unsigned long long) rule.accepted, (unsigned long long) rule.checked,
+                          rule.checked == 0 ? 0.0 : 100.0 * (double) rule.accepted / (double) rule.checked);
+            text += line;
+        }
+
+        return text;
+    }
+} }
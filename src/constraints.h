@@ -0,0 +1,82 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the constraints on the blindfold trace of the random
+ * cubes. A rule is compiled into a predicate on the coordinates of the
+ * cubie cube: the corner properties that only depend on the permutation
+ * are read from a table of the corner permutations, the edges are traced
+ * once per cube. The random cube generator checks the corners as soon as
+ * they are drawn and the edges before the cube is returned, so a cube is
+ * never solved to be thrown away.
+ */
+
+#ifndef MIN2PHASE_CONSTRAINTS_H
+#define MIN2PHASE_CONSTRAINTS_H 1
+
+#include <cstdint>
+#include <string>
+#include "CubieCube.h"
+
+namespace min2phase { namespace constraints {
+
+    /**
+     * The properties of the trace that can be constrained. The buffers
+     * are UFR and UF, the targets are counted with the cycle breaks.
+     */
+    typedef enum : int8_t {
+        CORNER_TARGETS = 0, ///The number of corner targets.
+        CORNER_CYCLES = 1,  ///The corner cycles longer than one piece.
+        TWISTS = 2,         ///The corners twisted in their position.
+        EDGE_TARGETS = 3,   ///The number of edge targets.
+        EDGE_CYCLES = 4,    ///The edge cycles longer than one piece.
+        FLIPS = 5,          ///The edges flipped in their position.
+        PARITY_TARGET = 6,  ///The last edge target (Speffz), the cubes have parity.
+        N_PROPERTIES = 7
+    }Property;
+
+    /**
+     * Compile a rule and add it to the constraints of the random cubes.
+     * The rule is "name=value" or "name=min-max", where the name is one of
+     * corner-targets, corner-cycles, twists, edge-targets, edge-cycles,
+     * flips, or "parity-target=letter" with a Speffz edge letter.
+     *
+     * @param rule  : the rule.
+     * @return      : false if the rule is malformed or out of range.
+     */
+    bool add(const std::string& rule);
+
+    /**
+     * Remove every constraint and reset the counters.
+     */
+    void clear();
+
+    /**
+     * Check the corner constraints on the corners of a cube.
+     *
+     * @param cube  : the cube, only the corners are read.
+     * @param cPerm : the corner permutation of the cube.
+     * @return      : true if the corners satisfy every constraint.
+     */
+    bool acceptCorners(const CubieCube& cube, uint16_t cPerm);
+
+    /**
+     * Check the edge constraints on the edges of a cube.
+     *
+     * @param cube  : the cube, only the edges are read.
+     * @return      : true if the edges satisfy every constraint.
+     */
+    bool acceptEdges(const CubieCube& cube);
+
+    /**
+     * Get the acceptance rate of every constraint: the cubes checked by
+     * the constraint and the ones it accepted, one line per constraint.
+     *
+     * @return      : the report, empty if there are no constraints.
+     */
+    std::string report();
+} }
+
+#endif //MIN2PHASE_CONSTRAINTS_H
@@ -7,6 +7,11 @@
 
 #include <min2phase/min2phase.h>
 #include "coords.h"
+#include "memory.h"
+
+#include <atomic>
+#include <new>
+#include <thread>
 
 namespace min2phase { namespace coords {
     typedef enum : uint8_t {
@@ -15,6 +20,7 @@ namespace min2phase { namespace coords {
         STP_IDX,
         SFP_IDX,
         TFP_IDX,
+        CTP_IDX,
         FLIP_TYPE,
         TWIST_TYPE,
         EPERM_TYPE
@@ -75,6 +81,47 @@ namespace min2phase { namespace coords {
      */
     static uint16_t SymStatePerm [info::N_PERM_SYM];
 
+    ///Distances used before the phase 1 pruning is ready
+
+    /**
+     * The moves to solve the corner orientation of every symmetry class.
+     */
+    static int8_t TwistDist[info::N_TWIST_SYM];
+
+    /**
+     * The moves to solve the edge orientation of every symmetry class.
+     */
+    static int8_t FlipDist[info::N_FLIP_SYM];
+
+    /**
+     * The moves to bring the UDSlice edges in the middle slice.
+     */
+    static int8_t UDSliceDist[info::N_SLICE];
+
+    /**
+     * This indicates if the phase 1 pruning tables can be read. It is
+     * set after the tables are completely written.
+     */
+    static std::atomic<bool> phase1Prun(false);
+
+    /**
+     * The set of tables computed.
+     */
+    static Profile profile = STANDARD_TABLES;
+
+    /**
+     * The thread that computes the phase 1 pruning tables in background.
+     * The thread is joined before the end of the program.
+     */
+    static struct builder_s {
+        std::thread thread;
+
+        ~builder_s() {
+            if (thread.joinable())
+                thread.join();
+        }
+    }builder;
+
     /**
      * This method compute the cubes generated from the 18 moves and store them in an array.
      */
@@ -137,9 +184,37 @@ namespace min2phase { namespace coords {
     void initUDSliceMoveConj();
 
     /**
-     * This method is used to create a configuration for the pruning compute.
+     * This method compute the corner permutation and orientation
+     * move and symmetry tables used by the corner pattern database.
+     */
+    void initCornerMoveConj();
+
+    /**
+     * This method computes the move tables, the symmetries and the phase 2 pruning,
+     * everything needed to start solving.
      */
-    void initAllPrun();
+    void initTables();
+
+    /**
+     * This method is used to create a configuration for the phase 2 pruning compute.
+     */
+    void initPhase2Prun();
+
+    /**
+     * This method is used to create a configuration for the phase 1 pruning compute.
+     */
+    void initPhase1Prun();
+
+    /**
+     * This method computes the distance to the solved coordinate of every
+     * coordinate, it is used for the weaker phase 1 bounds.
+     *
+     * @param dist  : the array to store the distances.
+     * @param size  : the size of the coordinate.
+     * @param move  : the move table of the coordinate.
+     * @param shift : the bits of the symmetry in the move table, 0 for raw coordinates.
+     */
+    void initDist(int8_t dist[], uint16_t size, const uint16_t move[][info::N_MOVES], int8_t shift);
 
     /**
      * This method compute the pruning table for every coordinate.
@@ -155,11 +230,14 @@ namespace min2phase { namespace coords {
      * @param PrunFlag      : the flag used to generate the pruning.
      * @param PrunTableSize : the size of the PrunFlag.
      * @param type          : the type of pruning computed, you determinate if from the type of coordinate.
+     * @param RawConj16     : the matrix of table for raw symmetry with the 16 symmetries
+     *                        and all the moves, it replaces RawConj2 if it is not null.
      */
     void initRawSymPrun(int32_t PrunTable[],
                         uint8_t RawMove1[][info::N_MOVES2], uint8_t RawConj1[][info::SYM], uint16_t SymMoveVect1[][info::N_MOVES2],
                         uint16_t RawMove2[][info::N_MOVES], uint16_t RawConj2[][info::SYM_CLASSES], uint16_t SymMoveVect2[][info::N_MOVES],
-                        const uint16_t SymState[], int32_t PrunFlag, int32_t PrunTableSize, const CoordType& type);
+                        const uint16_t SymState[], int32_t PrunFlag, int32_t PrunTableSize, const CoordType& type,
+                        uint16_t RawConj16[][info::SYM] = nullptr);
 
     /**
      * This method is used to check if a pruning value has the 0 value.
@@ -169,11 +247,79 @@ namespace min2phase { namespace coords {
      */
     bool hasZero(int32_t val);
 
-    coords_t coords;
+    /**
+     * Allocate the coordinates in a region that can be moved on huge pages.
+     *
+     * @return      : the coordinates object.
+     */
+    static coords_t& allocCoords() {
+        void* ptr = memory::allocate(sizeof(coords_t));
+
+        return ptr != nullptr ? *new(ptr) coords_t() : *new coords_t();
+    }
+
+    coords_t& coords = allocCoords();
+
+    //init all coordinates
+    void init(Profile p) {
+        wait();
+        profile = p;
+        initTables();
+        initPhase1Prun();
+        phase1Prun.store(true, std::memory_order_release);
+        coords.isInitialized = true;
+    }
+
+    //init the phase 1 pruning in background
+    void initAsync(Profile p) {
+        wait();
+        profile = p;
+        initTables();
+        coords.isInitialized = true;
+
+        builder.thread = std::thread([]() {
+            initPhase1Prun();
+            phase1Prun.store(true, std::memory_order_release);
+            MIN2PHASE_OUTPUT("Phase 1 pruning ready.")
+        });
+    }
+
+    Profile getProfile() {
+        return profile;
+    }
+
+    bool useCornerPrun() {
+        return profile == LARGE_TABLES && isComplete();
+    }
+
+    void wait() {
+        if (builder.thread.joinable())
+            builder.thread.join();
+    }
+
+    bool isInit() {
+        return coords.isInitialized;
+    }
+
+    bool isComplete() {
+        return phase1Prun.load(std::memory_order_acquire);
+    }
+
+    void setComplete(Profile p) {
+        wait();
+        profile = p;
+        initDist(TwistDist, info::N_TWIST_SYM, coords.TwistMove, 3);
+        initDist(FlipDist, info::N_FLIP_SYM, coords.FlipMove, 3);
+        initDist(UDSliceDist, info::N_SLICE, coords.UDSliceMove, 0);
+        coords.isInitialized = true;
+        phase1Prun.store(true, std::memory_order_release);
+    }
 
-        //init all coordinates
-    void init() {
+    //move tables, symmetries and phase 2 pruning
+    void initTables() {
         MIN2PHASE_OUTPUT("Info initialization.")
+        phase1Prun.store(false, std::memory_order_release);
+
         coords.urf.setCoords(2531, 1373, 67026819, 1367);
         coords.urfInv.setCoords(2089, 1906, 322752913, 2040);
 
@@ -189,13 +335,23 @@ namespace min2phase { namespace coords {
         initTwistMove();
         initUDSliceMoveConj();
 
-        initAllPrun();
+        if (profile == MINIMAL_TABLES)
+            memory::discard(coords.TwistFlipPrun, sizeof(coords.TwistFlipPrun));
 
-        coords.isInitialized = true;
-    }
+        if (profile == LARGE_TABLES)
+            initCornerMoveConj();
+        else {
+            memory::discard(coords.CPermFullMove, sizeof(coords.CPermFullMove));
+            memory::discard(coords.TwistRawMove, sizeof(coords.TwistRawMove));
+            memory::discard(coords.TwistConj, sizeof(coords.TwistConj));
+            memory::discard(coords.CPermTwistPrun, sizeof(coords.CPermTwistPrun));
+        }
 
-    bool isInit() {
-        return coords.isInitialized;
+        initPhase2Prun();
+
+        initDist(TwistDist, info::N_TWIST_SYM, coords.TwistMove, 3);
+        initDist(FlipDist, info::N_FLIP_SYM, coords.FlipMove, 3);
+        initDist(UDSliceDist, info::N_SLICE, coords.UDSliceMove, 0);
     }
 
     //b = S_idx^-1 * a * S_idx for only corner
@@ -257,7 +413,7 @@ namespace min2phase { namespace coords {
 
     //set value in pruning table
     void setPruning(int32_t table[], int32_t index, int8_t value) {
-        table[index >> 3] ^= value << ((index << 2)%(sizeof(int32_t)*8)); // index << 2 <=> (index & 7) << 2
+        table[index >> 3] ^= (int32_t) ((uint32_t) value << ((index << 2)%(sizeof(int32_t)*8))); // index << 2 <=> (index & 7) << 2
     }
 
     //get value in pruning table
@@ -266,7 +422,7 @@ namespace min2phase { namespace coords {
     }
 
     bool hasZero(int32_t val) {
-        return ((val - 0x11111111) & ~val & 0x88888888) != 0;
+        return (((uint32_t) val - 0x11111111u) & ~(uint32_t) val & 0x88888888u) != 0;
     }
 
     //init basic 18 moves
@@ -580,8 +736,38 @@ namespace min2phase { namespace coords {
         }
     }
 
-    //init pruning
-    void initAllPrun() {
+    //corner perm and orient move and sym table
+    void initCornerMoveConj() {
+        uint16_t i;
+        uint8_t j;
+        CubieCube c, d;
+
+        for (i = 0; i < info::N_PERM_SYM; i++) {
+            c.setCPerm(EPermS2R[i]);
+
+            for (j = 0; j < info::N_MOVES; j++) {
+                CubieCube::cornMult(c, coords.moveCube[j], d);
+                coords.CPermFullMove[i][j] = d.getCPermSym();
+            }
+        }
+
+        for (i = 0; i < info::N_TWIST; i++) {
+            c.setTwist(i);
+
+            for (j = 0; j < info::N_MOVES; j++) {
+                CubieCube::cornMult(c, coords.moveCube[j], d);
+                coords.TwistRawMove[i][j] = d.getTwist();
+            }
+
+            for (j = 0; j < info::SYM; j++) {
+                cornConjugate(c, coords.SymMultInv[0][j], d);
+                coords.TwistConj[i][j] = d.getTwist();
+            }
+        }
+    }
+
+    //init phase 2 pruning
+    void initPhase2Prun() {
         //coords.MCPermPrun
         initRawSymPrun(
                 coords.MCPermPrun,
@@ -599,7 +785,10 @@ namespace min2phase { namespace coords {
                 SymStatePerm, 0x7d824,
                 info::N_COMB * info::N_PERM_SYM / 8 + 1,
                 PCPP_IDX);
+    }
 
+    //init phase 1 pruning
+    void initPhase1Prun() {
         //SliceTwistPrun
         initRawSymPrun(
                 coords.UDSliceTwistPrun,
@@ -619,13 +808,54 @@ namespace min2phase { namespace coords {
                 SFP_IDX);
 
         //coords.TwistFlipPrun
-        initRawSymPrun(
-                coords.TwistFlipPrun,
-                nullptr, nullptr, nullptr,
-                nullptr, nullptr, coords.TwistMove,
-                SymStateTwist, 0x19603,
-                info::N_FLIP * info::N_TWIST_SYM / 8 + 1,
-                TFP_IDX);
+        if (profile != MINIMAL_TABLES)
+            initRawSymPrun(
+                    coords.TwistFlipPrun,
+                    nullptr, nullptr, nullptr,
+                    nullptr, nullptr, coords.TwistMove,
+                    SymStateTwist, 0x19603,
+                    info::N_FLIP * info::N_TWIST_SYM / 8 + 1,
+                    TFP_IDX);
+
+        //coords.CPermTwistPrun
+        if (profile == LARGE_TABLES)
+            initRawSymPrun(
+                    coords.CPermTwistPrun,
+                    nullptr, nullptr, nullptr,
+                    coords.TwistRawMove, nullptr, coords.CPermFullMove,
+                    SymStatePerm, 0xbc814,
+                    info::N_TWIST * info::N_PERM_SYM / 8 + 1,
+                    CTP_IDX, coords.TwistConj);
+    }
+
+    //distance from the solved coordinate
+    void initDist(int8_t dist[], uint16_t size, const uint16_t move[][info::N_MOVES], int8_t shift) {
+        uint16_t i, next;
+        int8_t depth, m;
+        bool found = true;
+
+        for (i = 0; i < size; i++)
+            dist[i] = -1;
+
+        dist[0] = 0;
+
+        for (depth = 0; found; depth++) {
+            found = false;
+
+            for (i = 0; i < size; i++) {
+                if (dist[i] != depth)
+                    continue;
+
+                for (m = 0; m < info::N_MOVES; m++) {
+                    next = move[i][m] >> shift;
+
+                    if (dist[next] == -1) {
+                        dist[next] = depth + 1;
+                        found = true;
+                    }
+                }
+            }
+        }
     }
 
     //0 coords.MCPermPrun
@@ -646,7 +876,7 @@ namespace min2phase { namespace coords {
                                                uint16_t RawConj2[][info::SYM_CLASSES],
                                                uint16_t SymMoveVect2[][info::N_MOVES],
                                                const uint16_t SymState[], int32_t PrunFlag, int32_t PrunTableSize,
-                                               const CoordType &type) {
+                                               const CoordType &type, uint16_t RawConj16[][info::SYM]) {
 
         const bool IS_TYPE_A = type < STP_IDX;
         const int8_t SYM_SHIFT = PrunFlag & 0xf;
@@ -657,10 +887,11 @@ namespace min2phase { namespace coords {
 
         const int8_t SYM_MASK = (1 << SYM_SHIFT) - 1;
         const bool ISTFP = type == TFP_IDX;
-        const uint16_t N_RAW = ISTFP ? info::N_FLIP : (type == MCPP_IDX ? info::N_MPERM : (type == PCPP_IDX
+        const bool ISCTP = type == CTP_IDX;
+        const uint16_t N_RAW = ISTFP ? info::N_FLIP : ISCTP ? info::N_TWIST : (type == MCPP_IDX ? info::N_MPERM : (type == PCPP_IDX
                                                                                                   ? info::N_COMB
                                                                                                   : info::N_SLICE));
-        const int32_t N_SIZE = N_RAW * (type == MCPP_IDX || type == PCPP_IDX ? info::N_PERM_SYM : type == SFP_IDX
+        const int32_t N_SIZE = N_RAW * (type == MCPP_IDX || type == PCPP_IDX || ISCTP ? info::N_PERM_SYM : type == SFP_IDX
                                                                                                       ? info::N_FLIP_SYM
                                                                                                       : info::N_TWIST_SYM);
         const int8_t N_MOVES = IS_PHASE2 ? info::N_MOVES2 : info::N_MOVES;
@@ -683,17 +914,17 @@ namespace min2phase { namespace coords {
         done = 1;
 
         while (depth < MAX_DEPTH) {
-            mask = (depth + 1) * 0x11111111 ^ 0xffffffff;
+            mask = (int32_t) ((uint32_t) (depth + 1) * 0x11111111u ^ 0xffffffffu);
 
             for (i = 0; i < PrunTableSize; i++) {
                 val = PrunTable[i] ^ mask;
                 val &= val >> 1;
-                PrunTable[i] += val & (val >> 2) & 0x11111111;
+                PrunTable[i] = (int32_t) ((uint32_t) PrunTable[i] + (uint32_t) (val & (val >> 2) & 0x11111111));
             }
 
             inv = depth > INV_DEPTH;
             select = inv ? (depth + 2) : depth;
-            selArrMask = select * 0x11111111;
+            selArrMask = (int32_t) ((uint32_t) select * 0x11111111u);
             check = inv ? depth : (depth + 2);
             depth++;
             xorVal = depth ^ (depth + 1);
@@ -730,6 +961,8 @@ namespace min2phase { namespace coords {
                         rawx = coords.FlipS2RF[
                                 coords.FlipMove[flip][coords.Sym8Move[m << 3 | fsym]] ^
                                 fsym ^ (symx & SYM_MASK)];
+                    else if (ISCTP)
+                        rawx = RawConj16[RawMove2[raw][m]][symx & SYM_MASK];
                     else
                         rawx = IS_TYPE_A ?
                                RawConj1[RawMove1[raw][m]][symx & SYM_MASK] :
@@ -762,6 +995,8 @@ namespace min2phase { namespace coords {
 
                         if (ISTFP)
                             idxx += coords.FlipS2RF[coords.FlipR2S[rawx] ^ j];
+                        else if (ISCTP)
+                            idxx += RawConj16[rawx][j ^ (SYM_E2C_MAGIC_P >> (j << 1) & 3)];
                         else
                             idxx += IS_TYPE_A ? RawConj1[rawx][j ^ (SYM_E2C_MAGIC_P >> (j << 1) & 3)] :
                                     RawConj2[rawx][j ^ (SYM_E2C_MAGIC_P >> (j << 1) & 3)];
@@ -776,7 +1011,29 @@ namespace min2phase { namespace coords {
         }
     }
 
+    /**
+     * Get the pruning of the corner and edge orientation. Without the
+     * twist-flip pruning table it returns the distances of the two
+     * coordinates, they are weaker but need no memory.
+     *
+     * @param twist : the corner orientation symmetry class.
+     * @param flip  : the edge orientation symmetry, class << 3 | symmetry.
+     * @return      : the pruning value.
+     */
+    static int8_t getTwistFlipPrun(uint16_t twist, uint16_t flip) {
+        if (profile == MINIMAL_TABLES)
+            return std::max(TwistDist[twist], FlipDist[flip >> 3]);
+
+        return getPruning(coords.TwistFlipPrun, twist << 11 | coords.FlipS2RF[flip]);
+    }
+
     void CoordCube::calcPrun(bool isPhase1) {
+        if (!isComplete()) {
+            prun = std::max(std::max(TwistDist[twist], FlipDist[flip]),
+                            std::max(UDSliceDist[slice], std::max(TwistDist[twistc >> 3], FlipDist[flipc >> 3])));
+            return;
+        }
+
         prun = std::max(
                 std::max(
                         getPruning(coords.UDSliceTwistPrun,
@@ -784,10 +1041,8 @@ namespace min2phase { namespace coords {
                         getPruning(coords.UDSliceFlipPrun,
                                    flip * info::N_SLICE + coords.UDSliceConj[slice][fsym])),
                 std::max(
-                         getPruning(coords.TwistFlipPrun,
-                                                          (twistc >> 3) << 11 | coords::coords.FlipS2RF[flipc ^ (twistc & 7)]),
-                        getPruning(coords.TwistFlipPrun,
-                                                                twist << 11 | coords::coords.FlipS2RF[flip << 3 | (fsym ^ tsym)])));
+                        getTwistFlipPrun(twistc >> 3, flipc ^ (twistc & 7)),
+                        getTwistFlipPrun(twist, flip << 3 | (fsym ^ tsym))));
     }
 
     bool CoordCube::setWithPrun(const CubieCube &cc, int8_t depth) {
@@ -796,8 +1051,25 @@ namespace min2phase { namespace coords {
         flip = cc.getFlipSym();
         tsym = twist & 7;
         twist = twist >> 3;
+        cperm = cc.getCPermSym();
+        twistr = cc.getTwist();
+
+        if (!isComplete()) {
+            fsym = flip & 7;
+            flip = flip >> 3;
+            slice = cc.getUDSlice();
+
+            cornConjugate(cc, 1, pc);
+            edgeConjugate(cc, 1, pc);
+            twistc = pc.getTwistSym();
+            flipc = pc.getFlipSym();
+
+            calcPrun(true);
+
+            return prun <= depth;
+        }
 
-        prun = getPruning(coords.TwistFlipPrun, twist << 11 | coords.FlipS2RF[flip ^ tsym]);
+        prun = getTwistFlipPrun(twist, flip ^ tsym);
 
         if (prun > depth)
             return false;
@@ -818,8 +1090,7 @@ namespace min2phase { namespace coords {
         twistc = pc.getTwistSym();
         flipc = pc.getFlipSym();
 
-        prun = std::max(prun,
-                        getPruning(coords.TwistFlipPrun, (twistc >> 3) << 11 | coords.FlipS2RF[flipc ^ (twistc & 7)]));
+        prun = std::max(prun, getTwistFlipPrun(twistc >> 3, flipc ^ (twistc & 7)));
 
         return prun <= depth;
     }
@@ -836,11 +1107,14 @@ namespace min2phase { namespace coords {
         tsym = (twist & 7) ^ cc.tsym;
         twist >>= 3;
 
+        if (!isComplete())
+            return prun = std::max(std::max(TwistDist[twist], FlipDist[flip]), UDSliceDist[slice]);
+
         prun = std::max(
                 std::max(
                         getPruning(coords.UDSliceTwistPrun, twist * info::N_SLICE + coords.UDSliceConj[slice][tsym]),
                         getPruning(coords.UDSliceFlipPrun, flip * info::N_SLICE + coords.UDSliceConj[slice][fsym])),
-                getPruning(coords.TwistFlipPrun, twist << 11 | coords.FlipS2RF[flip << 3 | (fsym ^ tsym)]));
+                getTwistFlipPrun(twist, flip << 3 | (fsym ^ tsym)));
 
         return prun;
     }
@@ -851,6 +1125,25 @@ namespace min2phase { namespace coords {
         flipc = coords.FlipMove[cc.flipc >> 3][coords.Sym8Move[m << 3 | cc.flipc & 7]] ^ (cc.flipc & 7);
         twistc = coords.TwistMove[cc.twistc >> 3][coords.Sym8Move[m << 3 | cc.twistc & 7]] ^ (cc.twistc & 7);
 
-        return getPruning(coords.TwistFlipPrun, (twistc >> 3) << 11 | coords.FlipS2RF[flipc ^ (twistc & 7)]);
+        if (!isComplete())
+            return std::max(TwistDist[twistc >> 3], FlipDist[flipc >> 3]);
+
+        return getTwistFlipPrun(twistc >> 3, flipc ^ (twistc & 7));
+    }
+
+    //move corner pattern database
+    int8_t CoordCube::doMovePrunCorner(const CoordCube &cc, int8_t m) {
+        const int8_t csym = cc.cperm & 0xf;
+
+        cperm = coords.CPermFullMove[cc.cperm >> 4][coords.SymMove[csym][m]];
+        cperm = cperm & 0xfff0 | coords.SymMult[cperm & 0xf][csym];
+        twistr = coords.TwistRawMove[cc.twistr][m];
+
+        return getPrunCorner();
+    }
+
+    //corner pattern database
+    int8_t CoordCube::getPrunCorner() const {
+        return getPruning(coords.CPermTwistPrun, (cperm >> 4) * info::N_TWIST + coords.TwistConj[twistr][cperm & 0xf]);
     }
-} }
\ No newline at end of file
+} }
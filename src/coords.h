@@ -27,6 +27,7 @@
 #ifndef MIN2PHASE_COORDS_H
 #define MIN2PHASE_COORDS_H 1
 
+#include <min2phase/min2phase.h>
 #include "CubieCube.h"
 
 namespace min2phase { namespace coords {
@@ -56,7 +57,7 @@ namespace min2phase { namespace coords {
          */
         CubieCube CubeSym[info::SYM];
 
-        int firstMoveSym[info::FULL_SYM] = {0};
+        int32_t firstMoveSym[info::FULL_SYM] = {0};
 
 
         int8_t SymMove[info::SYM][info::N_MOVES] = {0};//TODO
@@ -215,6 +216,29 @@ namespace min2phase { namespace coords {
         uint8_t CCombPMove[info::N_COMB][info::N_MOVES2] = {0};
 
 
+        ///corner pattern database, computed only with LARGE_TABLES
+
+        /**
+         * This matrix contains the moving table for the corner permutation with all the 18 moves.
+         */
+        uint16_t CPermFullMove[info::N_PERM_SYM][info::N_MOVES] = {0};
+
+        /**
+         * This matrix contains the moving table for the raw corner orientation.
+         */
+        uint16_t TwistRawMove[info::N_TWIST][info::N_MOVES] = {0};
+
+        /**
+         * This matrix contains the symmetries of the raw corner orientation.
+         */
+        uint16_t TwistConj[info::N_TWIST][info::SYM] = {0};
+
+        /**
+         * This matrix contains the pruning table for the corner permutation and orientation.
+         */
+        int32_t CPermTwistPrun[info::N_TWIST * info::N_PERM_SYM / info::SYM_CLASSES + 1] = {0};
+
+
 
         /**
          * This the S_URF symmetry that make a rotation of 120 degree of the cube around
@@ -238,14 +262,45 @@ namespace min2phase { namespace coords {
     }coords_t;
 
     /**
-     * The coordinates object for the algorithm.
+     * The coordinates object for the algorithm. It is stored in a region
+     * that can be moved on huge pages, see memory.h.
      */
-    extern coords_t coords;
+    extern coords_t& coords;
 
     /**
      * This function is used to compute all the coordinates and symmetries.
+     *
+     * @param profile   : the set of tables to compute.
+     */
+    void init(Profile profile);
+
+    /**
+     * This function computes the coordinates needed to start solving and
+     * returns. The phase 1 pruning tables are computed in background,
+     * until they are ready the phase 1 uses weaker bounds.
+     *
+     * @param profile   : the set of tables to compute.
+     */
+    void initAsync(Profile profile);
+
+    /**
+     * Get the set of tables used by the solver.
+     *
+     * @return      : the profile.
      */
-    void init();
+    Profile getProfile();
+
+    /**
+     * Check if the corner pattern database can be used.
+     *
+     * @return      : true with LARGE_TABLES after the initialization, false if not.
+     */
+    bool useCornerPrun();
+
+    /**
+     * Wait the end of the background initialization.
+     */
+    void wait();
 
     /**
      * Check if the coordinates are initialized.
@@ -254,6 +309,20 @@ namespace min2phase { namespace coords {
      */
     bool isInit();
 
+    /**
+     * Check if the phase 1 pruning tables are ready.
+     *
+     * @return      : True if ready, false if the weaker bounds are used.
+     */
+    bool isComplete();
+
+    /**
+     * Mark all the coordinates as ready, used after reading them from a file.
+     *
+     * @param profile   : the set of tables read.
+     */
+    void setComplete(Profile profile);
+
     /**
      * This function is used to convert the a cube into a new one from a symmetry index.
      * The symmetry is used to find 2 same cube and it increase the speed of the algorithm.
@@ -370,6 +439,16 @@ namespace min2phase { namespace coords {
          */
         uint16_t flipc;
 
+        /**
+         * This is the corner permutation symmetry, class << 4 | symmetry.
+         */
+        uint16_t cperm;
+
+        /**
+         * This is the raw corner orientation.
+         */
+        uint16_t twistr;
+
     public:
 
         /**
@@ -407,6 +486,25 @@ namespace min2phase { namespace coords {
          * @return   : the pruning value.
          */
         int8_t doMovePrunConj(const CoordCube &cc, int8_t m);
+
+        /**
+         * This is used to apply a move to the corner permutation and
+         * orientation and get the moves needed to solve the corners.
+         * Use it only if useCornerPrun() is true.
+         *
+         * @param cc : the cube used to move.
+         * @param m  : the move.
+         * @return   : the pruning value.
+         */
+        int8_t doMovePrunCorner(const CoordCube &cc, int8_t m);
+
+        /**
+         * This is used to get the moves needed to solve the corners of the
+         * stored cube. Use it only if useCornerPrun() is true.
+         *
+         * @return : the pruning value.
+         */
+        int8_t getPrunCorner() const;
     };
 } }
 
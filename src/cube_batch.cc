@@ -0,0 +1,219 @@
+#include "../include/cube_batch.h"
+#include "../include/turns.h"
+#include "../include/tracing.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__)
+#define CUBE_BATCH_VECTOR
+#if defined(__x86_64__) || defined(__i386__)
+#define CUBE_BATCH_X86
+#endif
+#endif
+
+namespace {
+    constexpr int LANES = CubeBatch::LANES;
+
+#ifdef CUBE_BATCH_VECTOR
+    // Lanes of a row in a SSE2, AVX2 and AVX-512 register
+    typedef uint8_t Lanes16 __attribute__((vector_size(16)));
+    typedef uint8_t Lanes32 __attribute__((vector_size(32)));
+    typedef uint8_t Lanes64 __attribute__((vector_size(64)));
+
+    // Rotates the cycles of the face by a different amount in every lane: by
+    // two where half is set, then by one where quarter is set. a ^ ((a ^ b) & mask)
+    // takes b where the mask is set
+    template<typename V>
+    __attribute__((always_inline))
+    inline void rotate_face(uint8_t (*state)[LANES], int first, int face, const V& half, const V& quarter) {
+        V row0, row1, row2, row3, rotated0, rotated1, rotated2, rotated3;
+
+        for (const auto& cycle : Turns::CYCLES[face]) {
+            std::memcpy(&row0, state[cycle[0]] + first, sizeof(V));
+            std::memcpy(&row1, state[cycle[1]] + first, sizeof(V));
+            std::memcpy(&row2, state[cycle[2]] + first, sizeof(V));
+            std::memcpy(&row3, state[cycle[3]] + first, sizeof(V));
+            rotated0 = row0 ^ ((row0 ^ row2) & half);
+            rotated1 = row1 ^ ((row1 ^ row3) & half);
+            rotated2 = row2 ^ ((row2 ^ row0) & half);
+            rotated3 = row3 ^ ((row3 ^ row1) & half);
+            row0 = rotated0 ^ ((rotated0 ^ rotated1) & quarter);
+            row1 = rotated1 ^ ((rotated1 ^ rotated2) & quarter);
+            row2 = rotated2 ^ ((rotated2 ^ rotated3) & quarter);
+            row3 = rotated3 ^ ((rotated3 ^ rotated0) & quarter);
+            std::memcpy(state[cycle[0]] + first, &row0, sizeof(V));
+            std::memcpy(state[cycle[1]] + first, &row1, sizeof(V));
+            std::memcpy(state[cycle[2]] + first, &row2, sizeof(V));
+            std::memcpy(state[cycle[3]] + first, &row3, sizeof(V));
+        }
+    }
+
+    // The power of the move of every lane gives the rotation of the cycles:
+    // a quarter turn is one step, a half turn two and a prime turn three
+    template<typename V>
+    __attribute__((always_inline))
+    inline void turn_rows(uint8_t (*state)[LANES], const uint8_t* moves) {
+        V move, power, half, quarter;
+
+        for (int first = 0; first < LANES; first += (int) sizeof(V)) {
+            std::memcpy(&move, moves + first, sizeof(V));
+            for (int face = 0; face < Turns::N_FACES; face++) {
+                power = move - (uint8_t) (face * 3);
+                half = (V) (power == 1) | (V) (power == 2);
+                quarter = (V) (power == 0) | (V) (power == 2);
+                rotate_face(state, first, face, half, quarter);
+            }
+        }
+    }
+#else
+    // Turns the lanes one at a time
+    void turn_rows(uint8_t (*state)[LANES], const uint8_t* moves) {
+        uint8_t values[4];
+        int shift;
+
+        for (int lane = 0; lane < LANES; lane++) {
+            if (moves[lane] >= Turns::N_MOVES) {
+                continue;
+            }
+            shift = moves[lane] % 3 + 1;
+            for (const auto& cycle : Turns::CYCLES[moves[lane] / 3]) {
+                for (int j = 0; j < 4; j++) {
+                    values[j] = state[cycle[j]][lane];
+                }
+                for (int j = 0; j < 4; j++) {
+                    state[cycle[j]][lane] = values[(j + shift) & 3];
+                }
+            }
+        }
+    }
+#endif
+
+#ifdef CUBE_BATCH_X86
+    // One register per row
+    __attribute__((target("avx512bw")))
+    void turn_avx512(uint8_t (*state)[LANES], const uint8_t* moves) {
+        turn_rows<Lanes64>(state, moves);
+    }
+
+    // Two registers per row
+    __attribute__((target("avx2")))
+    void turn_avx2(uint8_t (*state)[LANES], const uint8_t* moves) {
+        turn_rows<Lanes32>(state, moves);
+    }
+
+    // Four registers per row
+    void turn_sse2(uint8_t (*state)[LANES], const uint8_t* moves) {
+        turn_rows<Lanes16>(state, moves);
+    }
+
+    // Chooses the best turn for the cpu
+    void (*select_turn())(uint8_t (*)[LANES], const uint8_t*) {
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512bw")) {
+            return turn_avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return turn_avx2;
+        }
+
+        return turn_sse2;
+    }
+#endif
+}
+
+constexpr int CubeBatch::LANES;
+constexpr int CubeBatch::N_STICKERS;
+constexpr int CubeBatch::MAX_MOVES;
+
+// Default constructor: Initializes the solved cubes
+CubeBatch::CubeBatch() {
+    reset();
+}
+
+// Every row holds its own sticker in all the lanes
+void CubeBatch::reset() {
+    for (int i = 0; i < N_STICKERS; i++) {
+        std::memset(state[i], i, LANES);
+    }
+}
+
+// Rotates the cycles of all the faces, by zero steps in the lanes that turn
+// another face
+void CubeBatch::turn(const uint8_t* moves) {
+#ifdef CUBE_BATCH_X86
+    static void (*const turn_cpu)(uint8_t (*)[LANES], const uint8_t*) = select_turn();
+
+    turn_cpu(state, moves);
+#elif defined(CUBE_BATCH_VECTOR)
+    turn_rows<Lanes16>(state, moves);
+#else
+    turn_rows(state, moves);
+#endif
+}
+
+// The scrambles are parsed first, one row of moves per step: the shorter
+// scrambles are padded with N_MOVES
+void CubeBatch::scramble(const std::string* scrambles, int count, bool* valid) {
+    alignas(LANES) uint8_t moves[MAX_MOVES][LANES];
+    uint8_t lane_moves[MAX_MOVES];
+    int length = 0;
+    int n;
+
+    std::memset(moves, Turns::N_MOVES, sizeof(moves));
+    for (int lane = 0; lane < count; lane++) {
+        n = Turns::parse(scrambles[lane], lane_moves, MAX_MOVES);
+        valid[lane] = n >= 0;
+        for (int i = 0; i < n; i++) {
+            moves[i][lane] = lane_moves[i];
+        }
+        length = std::max(length, n);
+    }
+
+    reset();
+    for (int step = 0; step < length; step++) {
+        turn(moves[step]);
+    }
+}
+
+// Getter function for the state of a lane, the centers are solved
+std::array<unsigned short, 54> CubeBatch::get_state(int lane) const {
+    std::array<unsigned short, 54> stickers;
+
+    for (int i = 0; i < 54; i++) {
+        stickers[i] = i < N_STICKERS ? state[i][lane] : (unsigned short) i;
+    }
+
+    return stickers;
+}
+
+// Reads the pieces of every lane and checks them
+void CubeBatch::verify_ltct(char target, char twist, bool* verdicts, int count) const {
+    uint8_t stickers[N_STICKERS];
+    Cubies cubies;
+
+    for (int lane = 0; lane < count; lane++) {
+        for (int i = 0; i < N_STICKERS; i++) {
+            stickers[i] = state[i][lane];
+        }
+        Tracing::to_cubies(stickers, cubies);
+        verdicts[lane] = Tracing::verify_ltct(cubies, target, twist);
+    }
+}
+
+// Scrambles and checks LANES cubes at a time
+void CubeBatch::audit(const std::string* scrambles, size_t count, char target, char twist, bool* verdicts) {
+    CubeBatch batch;
+    bool valid[LANES];
+    int n;
+
+    for (size_t first = 0; first < count; first += LANES) {
+        n = (int) std::min<size_t>(LANES, count - first);
+        batch.scramble(scrambles + first, n, valid);
+        batch.verify_ltct(target, twist, verdicts + first, n);
+        for (int lane = 0; lane < n; lane++) {
+            verdicts[first + lane] = verdicts[first + lane] && valid[lane];
+        }
+    }
+}
@@ -0,0 +1,183 @@
+#include "../include/dedup.h"
+#include "../include/min2phase/tools.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr int StateSet::N_SHARDS;
+
+namespace {
+    // A free slot: no key has all the bits set
+    constexpr uint64_t EMPTY = ~(uint64_t) 0;
+
+    // Smallest table of a shard
+    constexpr size_t MIN_SLOTS = 16;
+
+    // Bits of the hash that choose the shard, the low bits choose the slot
+    constexpr int SHARD_SHIFT = 58;
+
+    // Most bits set for every state by the bloom filter
+    constexpr int MAX_HASHES = 16;
+
+    // Bits of a block of the bloom filter, the size of a cache line
+    constexpr size_t BLOCK_BITS = 512;
+
+    // Smallest power of two not less than n
+    size_t ceil_pow2(size_t n) {
+        size_t size = 1;
+
+        while (size < n) {
+            size <<= 1;
+        }
+
+        return size;
+    }
+
+    // Slot of the key or the free slot where it goes, the tables are never full
+    size_t find_slot(const std::vector<std::array<uint64_t, 2>>& slots, const uint64_t key[2], uint64_t hash) {
+        const size_t mask = slots.size() - 1;
+        size_t i = hash & mask;
+
+        while (slots[i][0] != EMPTY && (slots[i][0] != key[0] || slots[i][1] != key[1])) {
+            i = (i + 1) & mask;
+        }
+
+        return i;
+    }
+
+    // The tables are kept below 70% full
+    bool too_full(size_t count, size_t n_slots) {
+        return count * 10 >= n_slots * 7;
+    }
+}
+
+// Constructor: every shard gets its part of the expected states
+StateSet::StateSet(size_t expected) {
+    const size_t n_slots = ceil_pow2(std::max(MIN_SLOTS, expected / N_SHARDS * 10 / 7 + 1));
+
+    for (Shard& shard : shards) {
+        shard.slots.assign(n_slots, {{EMPTY, EMPTY}});
+    }
+}
+
+// Linear probing in the shard of the hash, the table doubles when it gets too full
+bool StateSet::insert(const uint64_t key[2]) {
+    const uint64_t hash = min2phase::tools::stateHash(key);
+    Shard& shard = shards[hash >> SHARD_SHIFT];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    size_t i = find_slot(shard.slots, key, hash);
+
+    if (shard.slots[i][0] != EMPTY) {
+        return false;
+    }
+
+    if (too_full(shard.count + 1, shard.slots.size())) {
+        std::vector<std::array<uint64_t, 2>> old(shard.slots.size() * 2, {{EMPTY, EMPTY}});
+
+        old.swap(shard.slots);
+        for (const std::array<uint64_t, 2>& slot : old) {
+            if (slot[0] != EMPTY) {
+                shard.slots[find_slot(shard.slots, slot.data(), min2phase::tools::stateHash(slot.data()))] = slot;
+            }
+        }
+        i = find_slot(shard.slots, key, hash);
+    }
+
+    shard.slots[i] = {{key[0], key[1]}};
+    shard.count++;
+
+    return true;
+}
+
+// Linear probing in the shard of the hash
+bool StateSet::contains(const uint64_t key[2]) const {
+    const uint64_t hash = min2phase::tools::stateHash(key);
+    const Shard& shard = shards[hash >> SHARD_SHIFT];
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    return shard.slots[find_slot(shard.slots, key, hash)][0] != EMPTY;
+}
+
+// Sum of the states of the shards
+size_t StateSet::size() const {
+    size_t count = 0;
+
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard.lock);
+
+        count += shard.count;
+    }
+
+    return count;
+}
+
+// Sum of the tables of the shards
+size_t StateSet::memory() const {
+    size_t bytes = sizeof(*this);
+
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard.lock);
+
+        bytes += shard.slots.capacity() * sizeof(shard.slots[0]);
+    }
+
+    return bytes;
+}
+
+// Constructor: m = -n ln(p) / ln(2)^2 bits rounded up to a power of two and
+// k = -log2(p) bits per state
+BloomFilter::BloomFilter(size_t expected, double false_positive) {
+    const double n = (double) std::max(expected, (size_t) 1);
+    const double ln2 = std::log(2.0);
+    const size_t n_bits = std::max((size_t) BLOCK_BITS, ceil_pow2((size_t) (-n * std::log(false_positive) / (ln2 * ln2))));
+
+    words.reset(new std::atomic<uint64_t>[n_bits / 64]);
+    for (size_t i = 0; i < n_bits / 64; i++) {
+        words[i].store(0, std::memory_order_relaxed);
+    }
+    mask = n_bits / BLOCK_BITS - 1;
+    n_hashes = std::min(MAX_HASHES, std::max(1, (int) std::lround(-std::log2(false_positive))));
+}
+
+// The low bits of the hash choose the block, the high ones the bits h1 + i * h2
+// of the block (double hashing): all the bits of a state are in 64 bytes
+bool BloomFilter::insert(const uint64_t key[2]) {
+    const uint64_t hash = min2phase::tools::stateHash(key);
+    std::atomic<uint64_t>* block = &words[(hash & mask) * (BLOCK_BITS / 64)];
+    const uint64_t step = hash >> 20 | 1;
+    uint64_t bit = hash >> 40, previous;
+    bool added = false;
+
+    for (int i = 0; i < n_hashes; i++, bit += step) {
+        previous = block[(bit % BLOCK_BITS) >> 6].fetch_or((uint64_t) 1 << (bit & 63), std::memory_order_relaxed);
+        added |= (previous >> (bit & 63) & 1) == 0;
+    }
+
+    return added;
+}
+
+// Checks the bits h1 + i * h2 of the block
+bool BloomFilter::contains(const uint64_t key[2]) const {
+    const uint64_t hash = min2phase::tools::stateHash(key);
+    const std::atomic<uint64_t>* block = &words[(hash & mask) * (BLOCK_BITS / 64)];
+    const uint64_t step = hash >> 20 | 1;
+    uint64_t bit = hash >> 40;
+
+    for (int i = 0; i < n_hashes; i++, bit += step) {
+        if ((block[(bit % BLOCK_BITS) >> 6].load(std::memory_order_relaxed) >> (bit & 63) & 1) == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// One bit per slot of the filter
+size_t BloomFilter::memory() const {
+    return sizeof(*this) + (mask + 1) * BLOCK_BITS / 8;
+}
+
+// Getter function for the bits set for every state
+int BloomFilter::hashes() const {
+    return n_hashes;
+}
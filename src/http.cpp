@@ -18,70 +18,326 @@
 #include <iostream>
 #include <thread>
 #include <sstream>
+#include <cerrno>
 
 #ifdef linux
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Search.h"
+#include "binary.h"
+#include "cache.h"
+#include "info.h"
+#include "metrics.h"
+#include "parser.h"
+#include "pools.h"
+
 #include<unistd.h>
+#include<fcntl.h>
+#include<sys/epoll.h>
+#include<sys/eventfd.h>
 #include<sys/socket.h>
+#include<sys/un.h>
+#include<netinet/in.h>
+#include<netinet/tcp.h>
 #include<netdb.h>
-#include <wait.h>
 
 namespace min2phase{ namespace http {
-        const uint8_t MSG_SIZE = 255;
+        /**
+         * The size of the buffer of the reads from a socket.
+         */
+        const uint16_t MSG_SIZE = 4096;
+
+        /**
+         * The number of events read by the event loop at every wait.
+         */
+        const int32_t N_EVENTS = 64;
+
+        /**
+         * The ids of the listening socket, of the wake up of the event loop
+         * and of the listening sockets of the binary protocol (TCP and
+         * Unix) in the epoll events, the connections start after them.
+         */
+        const uint64_t LISTEN_ID = 0;
+        const uint64_t WAKE_ID = 1;
+        const uint64_t BINARY_ID = 2;
+        const uint64_t UNIX_ID = 3;
+
+        /**
+         * The requests of a connection that wait for their responses, the
+         * next ones are read when the first ones are answered.
+         */
+        const uint64_t MAX_PIPELINE = 64;
+
+        /**
+         * The bytes read and not parsed yet and the bytes not written yet of
+         * a connection: past them the connection is not read until they go
+         * down, a client that does not read its responses can not grow the
+         * memory of the server.
+         */
+        const size_t MAX_INPUT = parser::MAX_HEAD + parser::MAX_BODY;
+        const size_t MAX_OUTPUT = 1 << 20;
+
+        /**
+         * The jobs waiting for each worker, the requests that need a worker
+         * are refused with 503 when the queue is full.
+         */
+        const size_t QUEUE_PER_WORKER = 64;
+
+        /**
+         * The parameters of a solve that are not in the query.
+         */
+        const int32_t DEFAULT_DEPTH = 21;
+        const int32_t DEFAULT_PROBE_MAX = 100000;
+
+        /**
+         * The time a request has from when it is read, in milliseconds: the
+         * default and the max of the parameter t.
+         */
+        const int32_t DEFAULT_TIMEOUT = 10000;
+        const int32_t MAX_TIMEOUT = 600000;
+
+        /**
+         * The most LTCT scrambles of a request.
+         */
+        const int32_t MAX_LTCT = 10000;
+
+        /**
+         * The parameters of a solve.
+         */
+        typedef struct options_s {
+            int32_t moves;
+            int32_t probeMax;
+            int32_t probeMin;
+            int32_t verbose;
+            int32_t timeout;
+        }options_t;
+
+        /**
+         * The cubes of a batch solve, or the case of the LTCT scrambles,
+         * shared by the jobs of the batch. A batch has at most one job per
+         * worker in the queue, a worker that ends one queues the next: the
+         * remaining jobs and the next one to queue are counted under the
+         * lock of the responses.
+         */
+        typedef struct batch_s {
+            std::vector<std::string> cubes;
+            options_t options;
+            char target;
+            char twist;
+            size_t remaining;
+            size_t size;
+            size_t next;
+            std::chrono::steady_clock::time_point deadline;
+        }batch_t;
+
+        /**
+         * A part of a response. A batch response is written in parts as
+         * its cubes are solved, it is complete with the last part.
+         */
+        typedef struct response_s {
+            std::string text;
+            bool complete;
+        }response_t;
+
+        /**
+         * A client connection, owned by the event loop. The requests are
+         * numbered in the order they are read and the responses that are
+         * ready before the ones of the previous requests wait in order.
+         * The flag is set when the client goes away, the workers stop the
+         * jobs of the connection.
+         */
+        typedef struct connection_s {
+            int32_t fd;
+            std::string input;
+            std::string output;
+            uint64_t requests;
+            uint64_t responses;
+            std::map<uint64_t, response_t> ready;
+            bool closing;
+            bool eof;
+            std::shared_ptr<std::atomic<bool>> cancelled;
+            bool binary;
+            bool paused;
+        }connection_t;
+
+        /**
+         * A request for the workers, with the response of the worker. The
+         * jobs of a batch solve one cube each: the one at the index. The
+         * jobs of the binary protocol have their frame instead of the
+         * request.
+         */
+        typedef struct job_s {
+            uint64_t id;
+            uint64_t sequence;
+            parser::request_t request;
+            std::string text;
+            bool last;
+            std::shared_ptr<batch_t> batch;
+            size_t index;
+            std::chrono::steady_clock::time_point deadline;
+            std::shared_ptr<std::atomic<bool>> cancelled;
+            bool isBinary;
+            binary::request_t frame;
+        }job_t;
+
         std::thread* server = nullptr;
-        int32_t socketfd;
-        bool isRunning = false;
+        std::vector<std::thread> workers;
+        int32_t socketfd, epollfd, wakefd, binaryfd = -1, unixfd = -1;
+        uint16_t backlog;
+        std::string unixPath;
+        std::atomic<bool> isRunning(false);
+
+        //requests waiting for a worker, counted by the event loop without the lock
+        std::mutex jobsLock;
+        std::condition_variable jobsReady;
+        std::deque<job_t> jobs;
+        std::atomic<size_t> queued(0);
+        size_t maxQueue = 0;
+
+        //responses waiting for the event loop
+        std::mutex doneLock;
+        std::vector<job_t> done;
+
+        //text of a status
+        const char* reason(uint16_t status){
+            switch (status){
+                case 200: return "OK";
+                case 400: return "Bad Request";
+                case 404: return "Not Found";
+                case 405: return "Method Not Allowed";
+                case 411: return "Length Required";
+                case 413: return "Payload Too Large";
+                case 431: return "Request Header Fields Too Large";
+                case 503: return "Service Unavailable";
+                default: return "Internal Server Error";
+            }
+        }
 
-        //SIGCHLD handler and cleaner
-        void childCleaner(int32_t s){
-            int32_t status;
-            wait(&status);
+        //build a response, the length of the body lets the client send the next request
+        std::string reply(uint16_t status, const std::string& body, bool keepAlive){
+            std::string text = "HTTP/1.1 " + std::to_string(status) + " " + reason(status) +
+                               "\r\nContent-Type: text/plain\r\nContent-Length: " + std::to_string(body.length());
 
-            MIN2PHASE_OUTPUT(std::string("Child output: ") + std::to_string(status));
+            //a refused request can be sent again later
+            if (status == 503)
+                text += "\r\nRetry-After: 1";
 
-            if(!isRunning){
-                signal(SIGCHLD, SIG_DFL);
-                MIN2PHASE_OUTPUT("Signal event removed.")
-            }
+            text += keepAlive ? "\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+            text += body;
+
+            return text;
+        }
+
+        //read a number of the query, the value is kept if it is missing
+        bool number(const std::string& query, const char* name, int32_t min, int32_t max, int32_t& value){
+            std::string text;
+            long n;
+            char* end;
+
+            if (!parser::param(query, name, text))
+                return true;
+
+            n = std::strtol(text.c_str(), &end, 10);
+
+            if (text.empty() || *end != '\0' || n < min || n > max)
+                return false;
+
+            value = (int32_t) n;
+
+            return true;
+        }
+
+        //read the parameters of a solve, the missing ones take their default
+        bool readOptions(const std::string& query, options_t& options){
+            options = {DEFAULT_DEPTH, DEFAULT_PROBE_MAX, 0, 0, DEFAULT_TIMEOUT};
+
+            return number(query, "m", 0, 31, options.moves) && number(query, "p", 0, INT32_MAX, options.probeMax) &&
+                   number(query, "P", 0, INT32_MAX, options.probeMin) && number(query, "v", 0, INT8_MAX, options.verbose) &&
+                   number(query, "t", 1, MAX_TIMEOUT, options.timeout);
+        }
+
+        //the deadline of a request read now, a wrong t is refused later with the other parameters
+        std::chrono::steady_clock::time_point deadline(const std::string& query,
+                                                       std::chrono::steady_clock::time_point now){
+            int32_t timeout = DEFAULT_TIMEOUT;
+
+            if (!number(query, "t", 1, MAX_TIMEOUT, timeout))
+                timeout = DEFAULT_TIMEOUT;
+
+            return now + std::chrono::milliseconds(timeout);
+        }
+
+        //frame a part of a chunked response
+        std::string chunk(const std::string& text){
+            char size[20];
+
+            std::snprintf(size, sizeof(size), "%zx\r\n", text.length());
+
+            return size + text + "\r\n";
+        }
+
+        //solve a cube of a batch, the line starts with the index of the cube; empty if an LTCT search was stopped
+        std::string solveBatch(const batch_t& batch, size_t index, Search& search){
+            const options_t& o = batch.options;
+            std::string scramble;
+
+            if (batch.target != '\0')
+                return (scramble = pools::generate(batch.target, batch.twist, search)).empty() ? "" :
+                       chunk(scramble + "\n");
+
+            return chunk(std::to_string(index) + " " + cache::solve(search, batch.cubes[index], (int8_t) o.moves,
+                                                                    o.probeMax, o.probeMin, (int8_t) o.verbose, nullptr) + "\n");
         }
 
         //convert string and compute the solution
-        std::string solveCube(const std::string& args){
-            int32_t pos, probeMax, probeMin;
-            int8_t moves, verbose;
+        std::string solveCube(const std::string& query, Search& search, uint16_t& status){
+            options_t o;
             uint8_t movesUsed = 0;
             std::string facelets;
             std::stringstream output;
 
-            try{
-                //c=YYWOYYGBOGGOOBRWBGRRYOOWWRROWBOWWBYRRGYWGYYBBGRBGRGWBOm=21p=10000P=0v=01
-                pos = args.find('m')+2;
-                facelets = args.substr(3, args.find('m') -4);
-                moves = std::stoi(args.substr(pos, args.find('p')-pos-1));
-                pos = args.find('p')+2;
-                probeMax = std::stoi(args.substr(pos, args.find('P')-pos-1));
-                pos = args.find('P')+2;
-                probeMin = std::stoi(args.substr(pos, args.find('v')-pos-1));
-                pos = args.find('v')+2;
-                verbose = std::stoi(args.substr(pos, args.length()-pos));
-
-                auto start = std::chrono::high_resolution_clock::now();
-                output << min2phase::solve(facelets, moves, probeMax, probeMin, verbose, &movesUsed);
-                auto end = std::chrono::high_resolution_clock::now();
+            //c=YYWOYYGBOGGOOBRWBGRRYOOWWRROWBOWWBYRRGYWGYYBBGRBGRGWBO&m=21&p=10000&P=0&v=1
+            if (!parser::param(query, "c", facelets) || !readOptions(query, o)){
+                status = 400;
+                return "malformed input\n0\n0ms\n";
+            }
 
-                output << "\n" << (int32_t) movesUsed << "\n" << std::chrono::duration_cast<std::chrono::milliseconds>(end-start).count() << "ms\n";
+            auto start = std::chrono::high_resolution_clock::now();
+            output << cache::solve(search, facelets, (int8_t) o.moves, o.probeMax, o.probeMin, (int8_t) o.verbose, &movesUsed);
+            auto end = std::chrono::high_resolution_clock::now();
 
-            }
-            catch (std::invalid_argument &e) {
-                output << "malformed input\n0\n0ms\n";
-            }
+            output << "\n" << (int32_t) movesUsed << "\n" << std::chrono::duration_cast<std::chrono::milliseconds>(end-start).count() << "ms\n";
+            status = 200;
 
             return output.str();
         }
 
-        //start server
-        bool startServer(const std::string& p, uint16_t mReq){
+        //add a socket to the event loop
+        bool watch(int32_t fd, uint64_t id, uint32_t events){
+            struct epoll_event event{};
+
+            event.events = events;
+            event.data.u64 = id;
+
+            return epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &event) == 0;
+        }
+
+        //open a listening TCP socket, -1 if it failed
+        int32_t listenTcp(const std::string& p, uint16_t mReq){
             struct addrinfo serverAdr{}, *res;
+            int32_t reuse = 1, fd;
 
             memset(&serverAdr, 0, sizeof(serverAdr));
 
@@ -90,19 +346,39 @@ namespace min2phase{ namespace http {
             serverAdr.ai_flags = AI_PASSIVE;
 
             if(getaddrinfo(nullptr, p.c_str(), &serverAdr, &res) != 0)
-                return false;
+                return -1;
 
-            socketfd = socket(AF_INET, SOCK_STREAM, 0);
+            fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
 
-            if (socketfd == -1)
-                return false;
+            if (fd == -1){
+                freeaddrinfo(res);
+                return -1;
+            }
 
-            if (bind(socketfd, res->ai_addr, res->ai_addrlen) != 0)
-                return false;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            if (bind(fd, res->ai_addr, res->ai_addrlen) != 0 || listen(fd, mReq) != 0){
+                freeaddrinfo(res);
+                close(fd);
+                return -1;
+            }
 
             freeaddrinfo(res);
 
-            if(listen(socketfd, mReq) != 0 )
+            return fd;
+        }
+
+        //start server
+        bool startServer(const std::string& p, uint16_t mReq){
+            if ((socketfd = listenTcp(p, mReq)) == -1)
+                return false;
+
+            backlog = mReq;
+
+            epollfd = epoll_create1(0);
+            wakefd = eventfd(0, EFD_NONBLOCK);
+
+            if(epollfd == -1 || wakefd == -1 || !watch(socketfd, LISTEN_ID, EPOLLIN) || !watch(wakefd, WAKE_ID, EPOLLIN))
                 return false;
 
             MIN2PHASE_OUTPUT("HTTP Server started.")
@@ -110,60 +386,656 @@ namespace min2phase{ namespace http {
             return true;
         }
 
-        //respond handler
-        void respond(int32_t client){
-            char msg[MSG_SIZE], *lines[3];
-            std::string output;
+        //answer the requests that take no time in the event loop, false if it needs a worker
+        bool answer(const parser::request_t& request, std::string& response){
+            MIN2PHASE_OUTPUT(request.path)
+
+            if (request.status != 0)
+                response = reply(request.status, "", false);
+            else if (request.method != "GET" || request.path == "/solve")
+                response = reply(405, "", request.keepAlive);
+            else if (request.path == "/" && request.query.empty())
+                response = reply(200, "k\n", request.keepAlive);
+            else if (request.path == "/stats")
+                response = reply(200, cache::stats() + pools::stats(), request.keepAlive);
+            else if (request.path == "/metrics")
+                response = reply(200, metrics::text(), request.keepAlive);
+            else if (request.path != "/" && request.path != "/r")
+                response = reply(404, "", request.keepAlive);
+            else
+                return false;
+
+            return true;
+        }
+
+        //the kind of a request for the metrics
+        metrics::endpoint_t endpoint(const parser::request_t& request){
+            if (request.status != 0)
+                return metrics::INVALID;
+
+            if (request.method == "POST")
+                return request.path == "/solve" ? metrics::BATCH : metrics::INVALID;
+
+            if (request.method != "GET")
+                return metrics::INVALID;
+
+            if (request.path == "/")
+                return request.query.empty() ? metrics::PING : metrics::SOLVE;
+
+            if (request.path == "/r")
+                return metrics::RANDOM;
+
+            if (request.path == "/ltct")
+                return metrics::LTCT;
+
+            if (request.path == "/stats")
+                return metrics::STATS;
+
+            return request.path == "/metrics" ? metrics::METRICS : metrics::INVALID;
+        }
 
-            memset((void*)msg, (int32_t)'\0', MSG_SIZE );
+        //respond to a request
+        std::string respond(const parser::request_t& request, Search& search){
+            uint16_t status = 200;
+            std::string body;
 
-            if (recv(client, msg, MSG_SIZE, 0) > 0){
-                lines[0] = strtok (msg, " ");
-                lines[1] = strtok (nullptr, " ");
-                lines[2] = strtok (nullptr, "\n");
+            if (request.path == "/r")
+                body = tools::randomCube();
+            else
+                body = solveCube(request.query, search, status);
+
+            return reply(status, body, request.keepAlive);
+        }
+
+        //solve a request of the binary protocol
+        std::string solveFrame(const binary::request_t& frame, Search& search){
+            RemoteSolution solution;
+            std::string facelets, response;
+
+            binary::toFacelets(frame.key, facelets);
+            binary::toMoves(cache::solve(search, facelets, frame.maxDepth, frame.probeMax, frame.probeMin,
+                                         frame.verbose & (INVERSE_SOLUTION | OPTIMAL_SOLUTION), nullptr), solution);
+            binary::writeResponse(frame.id, solution, response);
 
-                MIN2PHASE_OUTPUT(lines[1])
+            return response;
+        }
+
+        //the response of a job that is not done: its client went away or its deadline passed
+        std::string expire(const job_t& job){
+            const RemoteSolution late = {info::TIME_LIMIT, 0, {0}};
+            std::string response;
 
-                if (strncmp(lines[0], "GET\0", 4) == 0) {
+            metrics::shed(job.cancelled->load() ? metrics::DISCONNECTED : metrics::DEADLINE);
 
-                    if (strncmp(lines[2], "HTTP/1.0", 8) != 0 && strncmp(lines[2], "HTTP/1.1", 8) != 0)
-                        send(client, "HTTP/1.0 400 Bad Request\n", 25, MSG_NOSIGNAL);
-                    else{
-                        output = "HTTP/1.1 200 OK\n\n";
+            if (job.isBinary){
+                binary::writeResponse(job.frame.id, late, response);
+                return response;
+            }
 
-                        if(strlen(lines[1]) == 1)
-                            output += "k\n";
-                        else if(strcmp(lines[1], "/r") == 0)
-                            output += tools::randomCube();
-                        else
-                            output += solveCube(lines[1]);
+            if (job.batch == nullptr)
+                return reply(503, "deadline exceeded\n", job.request.keepAlive);
 
-                        send(client, output.c_str(), output.length(), MSG_NOSIGNAL);
-                        MIN2PHASE_OUTPUT("Message sent.")
+            if (job.batch->target != '\0')
+                return chunk(std::to_string(info::TIME_LIMIT) + "\n");
+
+            return chunk(std::to_string(job.index) + " " + std::to_string(info::TIME_LIMIT) + "\n");
+        }
+
+        //solver thread: every worker keeps its own search
+        void worker(){
+            Search search;
+            job_t job, next;
+            const uint64_t wake = 1;
+            bool more;
+
+            while (true){
+                {
+                    std::unique_lock<std::mutex> lock(jobsLock);
+
+                    jobsReady.wait(lock, []{ return !jobs.empty() || !isRunning; });
+
+                    //the jobs still queued when the server stops are dropped
+                    if (!isRunning)
+                        return;
+
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                }
+
+                queued--;
+                metrics::gauge(metrics::QUEUE_DEPTH, -1);
+                metrics::gauge(metrics::BUSY_WORKERS, 1);
+
+                //the searches stop at the deadline of the request or when the client goes away
+                search.setBudget(job.deadline, job.cancelled.get());
+
+                if (job.cancelled->load() || std::chrono::steady_clock::now() >= job.deadline)
+                    job.text = expire(job);
+                else if (job.isBinary)
+                    job.text = solveFrame(job.frame, search);
+                else if (job.batch == nullptr)
+                    job.text = respond(job.request, search);
+                else if ((job.text = solveBatch(*job.batch, job.index, search)).empty())
+                    job.text = expire(job);
+
+                metrics::gauge(metrics::BUSY_WORKERS, -1);
+
+                {
+                    std::lock_guard<std::mutex> lock(doneLock);
+
+                    //the last cube of a batch ends the response, after the parts of the others
+                    if (job.batch != nullptr && --job.batch->remaining == 0){
+                        job.text += chunk("");
+                        job.last = true;
                     }
+
+                    //the next cube of the batch takes the place of this one in the queue
+                    if ((more = job.batch != nullptr && job.batch->next < job.batch->size))
+                        next = {job.id, job.sequence, parser::request_t(), "", false, job.batch, job.batch->next++,
+                                job.deadline, job.cancelled, false, {}};
+
+                    job.batch.reset();
+                    done.push_back(std::move(job));
+                }
+
+                if (more){
+                    queued++;
+                    metrics::gauge(metrics::QUEUE_DEPTH, 1);
+
+                    std::lock_guard<std::mutex> lock(jobsLock);
+                    jobs.push_back(std::move(next));
+                }
+
+                if (write(wakefd, &wake, sizeof(wake)) < 0){
+                    MIN2PHASE_OUTPUT("Wake up failed.")
+                }
+            }
+        }
+
+        //write the pending output, false if the connection failed
+        bool flush(connection_t& c){
+            ssize_t sent;
+
+            while (!c.output.empty()){
+                sent = send(c.fd, c.output.data(), c.output.length(), MSG_NOSIGNAL);
+
+                if (sent < 0)
+                    return errno == EAGAIN;
+
+                c.output.erase(0, (size_t) sent);
+            }
+
+            return true;
+        }
+
+        //the connection can take more requests: the input, the requests in flight and the output are under their limits
+        bool hasRoom(const connection_t& c){
+            return c.input.length() < MAX_INPUT && c.requests - c.responses < MAX_PIPELINE && c.output.length() < MAX_OUTPUT;
+        }
+
+        //read what the client sent up to the limits, false if the connection failed
+        bool receive(connection_t& c){
+            char msg[MSG_SIZE];
+            ssize_t size = -1;
+
+            while (!(c.paused = !hasRoom(c)) && (size = recv(c.fd, msg, MSG_SIZE, 0)) > 0)
+                c.input.append(msg, (size_t) size);
+
+            c.eof |= size == 0;
+
+            return c.paused || size == 0 || errno == EAGAIN;
+        }
+
+        //queue a part of a response, the responses are written in the order of the requests
+        void deliver(connection_t& c, uint64_t sequence, std::string&& response, bool complete){
+            if (sequence != c.responses){
+                response_t& r = c.ready[sequence];
+
+                r.text += response;
+                r.complete = complete;
+                return;
+            }
+
+            c.output += response;
+
+            if (!complete)
+                return;
+
+            c.responses++;
+            metrics::gauge(metrics::IN_FLIGHT, -1);
+
+            for (auto r = c.ready.begin(); r != c.ready.end() && r->first == c.responses; r = c.ready.erase(r)){
+                c.output += r->second.text;
+
+                //the next parts of this response are written as they come
+                if (!r->second.complete){
+                    c.ready.erase(r);
+                    return;
                 }
+
+                c.responses++;
+                metrics::gauge(metrics::IN_FLIGHT, -1);
+            }
+        }
+
+        //read a batch solve, the cubes are in the body
+        std::shared_ptr<batch_t> readBatch(const parser::request_t& request){
+            std::shared_ptr<batch_t> batch = std::make_shared<batch_t>();
+
+            if (!readOptions(request.query, batch->options) || !parser::readCubes(request.body, batch->cubes))
+                return nullptr;
+
+            batch->target = '\0';
+            batch->remaining = batch->cubes.size();
+
+            return batch;
+        }
+
+        //read a request of LTCT scrambles: /ltct?target=X&twist=Y&n=N
+        std::shared_ptr<batch_t> readLtct(const parser::request_t& request){
+            std::shared_ptr<batch_t> batch = std::make_shared<batch_t>();
+            std::string target, twist = "C";
+            int32_t n = 1, timeout = DEFAULT_TIMEOUT;
+
+            if (!parser::param(request.query, "target", target) || target.length() != 1 ||
+                (parser::param(request.query, "twist", twist) && twist.length() != 1) ||
+                !tools::validLtct(target[0], twist[0]) || !number(request.query, "n", 0, MAX_LTCT, n) ||
+                !number(request.query, "t", 1, MAX_TIMEOUT, timeout))
+                return nullptr;
+
+            batch->target = target[0];
+            batch->twist = twist[0];
+            batch->remaining = (size_t) n;
+
+            return batch;
+        }
+
+        //the queue of the workers has no room for more jobs
+        bool isFull(size_t pending){
+            if (queued.load() + pending < maxQueue)
+                return false;
+
+            metrics::shed(metrics::QUEUE_FULL);
+
+            return true;
+        }
+
+        //start a batch: the jobs are done by the workers and streamed in parts
+        void startBatch(uint64_t id, connection_t& c, const parser::request_t& request,
+                        const std::shared_ptr<batch_t>& batch, std::chrono::steady_clock::time_point now,
+                        std::vector<job_t>& solves){
+            const uint64_t sequence = c.requests++;
+            std::string head, scramble;
+            size_t size;
+
+            if (batch == nullptr){
+                deliver(c, sequence, reply(400, "malformed input\n", request.keepAlive), true);
+                return;
+            }
+
+            //a batch takes the place of one request, its cubes are queued as the workers take them
+            if (isFull(solves.size())){
+                deliver(c, sequence, reply(503, "overloaded\n", request.keepAlive), true);
+                return;
+            }
+
+            batch->deadline = deadline(request.query, now);
+
+            head = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nTransfer-Encoding: chunked\r\n";
+            head += request.keepAlive ? "\r\n" : "Connection: close\r\n\r\n";
+
+            //the LTCT scrambles ready in the pool are sent at once, the workers make the others
+            while (batch->target != '\0' && batch->remaining > 0 && pools::take(batch->target, batch->twist, scramble)){
+                head += chunk(scramble + "\n");
+                batch->remaining--;
+            }
+
+            size = batch->remaining;
+
+            if (size == 0){
+                deliver(c, sequence, head + chunk(""), true);
+                return;
             }
+
+            deliver(c, sequence, std::move(head), false);
+
+            batch->size = size;
+            batch->next = std::min(size, workers.size());
+
+            for (size_t i = 0; i < batch->next; i++)
+                solves.push_back({id, sequence, parser::request_t(), "", false, batch, i, batch->deadline, c.cancelled,
+                                  false, {}});
         }
 
-        //handle request
+        //read the requests of the binary protocol, the solves go to the workers
+        size_t readFrames(uint64_t id, connection_t& c, std::chrono::steady_clock::time_point now,
+                          std::vector<job_t>& solves){
+            binary::request_t frame;
+            RemoteSolution refused = {0, 0, {0}};
+            std::string facelets, response;
+            size_t start = 0, used;
+
+            while (!c.closing && c.requests - c.responses < MAX_PIPELINE && c.output.length() < MAX_OUTPUT &&
+                   (used = binary::readRequest(c.input, start, frame)) > 0){
+                //a wrong length leaves nothing that can be read in the stream
+                if (used == SIZE_MAX){
+                    c.closing = true;
+                    break;
+                }
+
+                start += used;
+                metrics::request(metrics::BINARY);
+                metrics::gauge(metrics::IN_FLIGHT, 1);
+
+                if (frame.maxDepth < 0 || frame.maxDepth > info::MAX_LENGTH || frame.probeMax < 0 ||
+                    frame.probeMin < 0 || frame.timeout > (uint32_t) MAX_TIMEOUT ||
+                    !binary::toFacelets(frame.key, facelets))
+                    refused.error = binary::MALFORMED;
+                else if (isFull(solves.size()))
+                    refused.error = binary::BUSY;
+                else {
+                    solves.push_back({id, c.requests++, parser::request_t(), "", true, nullptr, 0,
+                                      now + std::chrono::milliseconds(frame.timeout == 0 ? DEFAULT_TIMEOUT : frame.timeout),
+                                      c.cancelled, true, frame});
+                    continue;
+                }
+
+                response.clear();
+                binary::writeResponse(frame.id, refused, response);
+                deliver(c, c.requests++, std::move(response), true);
+            }
+
+            return start;
+        }
+
+        //parse the requests read so far, the solves go to the workers
+        void process(uint64_t id, connection_t& c){
+            const auto now = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point until;
+            std::vector<job_t> solves;
+            parser::request_t request;
+            std::string response;
+            size_t start = 0, used;
+
+            if (c.binary)
+                start = readFrames(id, c, now, solves);
+
+            while (!c.binary && !c.closing && c.requests - c.responses < MAX_PIPELINE && c.output.length() < MAX_OUTPUT &&
+                   (used = parser::parse(c.input, start, request)) > 0){
+                MIN2PHASE_OUTPUT("Request received.")
+
+                start += used;
+                c.closing = !request.keepAlive;
+                metrics::request(endpoint(request));
+                metrics::gauge(metrics::IN_FLIGHT, 1);
+
+                if (request.status == 0 && request.method == "POST" && request.path == "/solve")
+                    startBatch(id, c, request, readBatch(request), now, solves);
+                else if (request.status == 0 && request.method == "GET" && request.path == "/ltct")
+                    startBatch(id, c, request, readLtct(request), now, solves);
+                else if (answer(request, response))
+                    deliver(c, c.requests++, std::move(response), true);
+                else if (isFull(solves.size()))
+                    deliver(c, c.requests++, reply(503, "overloaded\n", request.keepAlive), true);
+                else {
+                    until = deadline(request.query, now);
+                    solves.push_back({id, c.requests++, std::move(request), "", true, nullptr, 0, until, c.cancelled,
+                                      false, {}});
+                }
+            }
+
+            c.input.erase(0, c.closing ? c.input.length() : start);
+
+            if (solves.empty())
+                return;
+
+            queued += solves.size();
+            metrics::gauge(metrics::QUEUE_DEPTH, (int64_t) solves.size());
+
+            {
+                std::lock_guard<std::mutex> lock(jobsLock);
+                for (job_t& job : solves)
+                    jobs.push_back(std::move(job));
+            }
+
+            if (solves.size() == 1)
+                jobsReady.notify_one();
+            else
+                jobsReady.notify_all();
+        }
+
+        //close a connection, its requests without a response are not in flight anymore
+        void release(std::unordered_map<uint64_t, connection_t>& connections, uint64_t id){
+            auto c = connections.find(id);
+
+            if (c == connections.end())
+                return;
+
+            metrics::gauge(metrics::CONNECTIONS, -1);
+            metrics::gauge(metrics::IN_FLIGHT, -(int64_t) (c->second.requests - c->second.responses));
+            c->second.cancelled->store(true);
+            shutdown(c->second.fd, SHUT_RDWR);
+            close(c->second.fd);
+            connections.erase(c);
+        }
+
+        //read, parse and answer a connection, the connection is closed when it has nothing more to answer;
+        //with the edge triggered events the reads paused at the limits go on here when there is room again
+        void serve(std::unordered_map<uint64_t, connection_t>& connections, uint64_t id, bool readable){
+            connection_t& c = connections.at(id);
+            size_t before;
+
+            do {
+                if ((readable || c.paused) && !receive(c)){
+                    release(connections, id);
+                    return;
+                }
+
+                readable = false;
+
+                //a client that closed its side does not wait for the searches of its requests
+                if (c.eof && c.requests != c.responses)
+                    c.cancelled->store(true);
+
+                if (!flush(c)){
+                    release(connections, id);
+                    return;
+                }
+
+                before = c.input.length();
+                process(id, c);
+
+                if (!flush(c)){
+                    release(connections, id);
+                    return;
+                }
+            } while (c.output.empty() && ((c.paused && hasRoom(c)) || (c.input.length() != before && !c.input.empty())));
+
+            if ((c.closing || c.eof) && c.requests == c.responses && c.output.empty())
+                release(connections, id);
+        }
+
+        //event loop: accepts the connections, reads the requests and writes the responses
         void requestHandler(){
-            int32_t client, e;
+            std::unordered_map<uint64_t, connection_t> connections;
+            struct epoll_event events[N_EVENTS];
+            std::vector<job_t> responses;
+            std::vector<uint64_t> answered;
+            uint64_t nextId = UNIX_ID + 1, id, wake;
+            int32_t client, n, i, noDelay = 1;
 
             while (isRunning){
-                client = accept(socketfd, nullptr, nullptr);
+                n = epoll_wait(epollfd, events, N_EVENTS, -1);
+
+                for (i = 0; i < n; i++){
+                    id = events[i].data.u64;
+
+                    if (id == LISTEN_ID || id == BINARY_ID || id == UNIX_ID){
+                        while ((client = accept4(id == LISTEN_ID ? socketfd : id == BINARY_ID ? binaryfd : unixfd,
+                                                 nullptr, nullptr, SOCK_NONBLOCK)) >= 0){
+                            if (id != UNIX_ID)
+                                setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+                            if (watch(client, nextId, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET)){
+                                connections[nextId++] = {client, "", "", 0, 0, {}, false, false,
+                                                         std::make_shared<std::atomic<bool>>(false), id != LISTEN_ID, false};
+                                metrics::gauge(metrics::CONNECTIONS, 1);
+                            } else {
+                                close(client);
+                            }
+                        }
+                    } else if (id == WAKE_ID){
+                        if (read(wakefd, &wake, sizeof(wake)) < 0){
+                            MIN2PHASE_OUTPUT("Wake up failed.")
+                        }
 
-                if (client >= 0) {
+                        {
+                            std::lock_guard<std::mutex> lock(doneLock);
+                            responses.swap(done);
+                        }
+
+                        //the responses of a client that went away are dropped
+                        for (job_t& response : responses){
+                            auto c = connections.find(response.id);
 
-                    MIN2PHASE_OUTPUT("Request received.")
+                            if (c == connections.end())
+                                continue;
 
-                    if(fork() == 0) {
-                        respond(client);
-                        e = shutdown(client, SHUT_RDWR);
-                        e += close(client);
-                        exit(e);
+                            deliver(c->second, response.sequence, std::move(response.text), response.last);
+                            answered.push_back(response.id);
+                        }
+                        responses.clear();
+
+                        //the pipelined requests wait for these responses
+                        std::sort(answered.begin(), answered.end());
+                        answered.erase(std::unique(answered.begin(), answered.end()), answered.end());
+
+                        for (uint64_t a : answered)
+                            serve(connections, a, false);
+                        answered.clear();
+                    } else {
+                        if (connections.find(id) != connections.end())
+                            serve(connections, id, (events[i].events & EPOLLIN) != 0);
                     }
                 }
             }
+
+            //the searches of the connections stop, the server does not wait for them
+            while (!connections.empty())
+                release(connections, connections.begin()->first);
+        }
+
+        /**
+         * The connection of a thread to a remote solver, kept open for the
+         * next requests to the same server.
+         */
+        typedef struct remote_s {
+            std::string host;
+            int32_t port;
+            int32_t fd;
+            std::string input;
+
+            ~remote_s(){
+                if (fd >= 0)
+                    close(fd);
+            }
+        }remote_t;
+
+        thread_local remote_t remote = {"", 0, -1, ""};
+        thread_local remote_t binaryRemote = {"", 0, -1, ""};
+
+        //connect to a remote solver
+        const char* connectRemote(remote_t& remote, const std::string& ip, int32_t port){
+            struct addrinfo hints{}, *res;
+            int32_t noDelay = 1;
+
+            if (remote.fd >= 0)
+                close(remote.fd);
+
+            remote = {ip, port, -1, ""};
+
+            hints.ai_family = AF_INET;
+            hints.ai_socktype = SOCK_STREAM;
+
+            if (getaddrinfo(ip.c_str(), std::to_string(port).c_str(), &hints, &res) != 0)
+                return "no host";
+
+            remote.fd = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+            if (remote.fd == -1){
+                freeaddrinfo(res);
+                return "no client";
+            }
+
+            setsockopt(remote.fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+            if (connect(remote.fd, res->ai_addr, res->ai_addrlen) == -1){
+                freeaddrinfo(res);
+                close(remote.fd);
+                remote.fd = -1;
+                return "unable to connect";
+            }
+
+            freeaddrinfo(res);
+
+            return nullptr;
+        }
+
+        //connect to a remote solver on a Unix socket
+        const char* connectUnix(remote_t& remote, const std::string& path){
+            struct sockaddr_un address{};
+
+            if (remote.fd >= 0)
+                close(remote.fd);
+
+            remote = {path, -1, -1, ""};
+
+            if (path.length() >= sizeof(address.sun_path))
+                return "no host";
+
+            address.sun_family = AF_UNIX;
+            std::memcpy(address.sun_path, path.c_str(), path.length());
+
+            remote.fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+            if (remote.fd == -1)
+                return "no client";
+
+            if (connect(remote.fd, (struct sockaddr*) &address, sizeof(address)) == -1){
+                close(remote.fd);
+                remote.fd = -1;
+                return "unable to connect";
+            }
+
+            return nullptr;
+        }
+
+        //read a response of the remote solver, false if the server closed the connection
+        bool readResponse(std::string& head, std::string& body){
+            char msg[MSG_SIZE];
+            ssize_t size;
+            size_t end, length, pos;
+
+            while ((end = remote.input.find("\r\n\r\n")) == std::string::npos){
+                if ((size = recv(remote.fd, msg, MSG_SIZE, 0)) <= 0)
+                    return false;
+                remote.input.append(msg, (size_t) size);
+            }
+
+            head = parser::lower(remote.input.substr(0, end + 2));
+            pos = head.find("\r\ncontent-length:");
+            length = pos == std::string::npos ? 0 : std::strtoul(head.c_str() + pos + 17, nullptr, 10);
+
+            while (remote.input.length() < end + 4 + length){
+                if ((size = recv(remote.fd, msg, MSG_SIZE, 0)) <= 0)
+                    return false;
+                remote.input.append(msg, (size_t) size);
+            }
+
+            body = remote.input.substr(end + 4, length);
+            remote.input.erase(0, end + 4 + length);
+
+            return true;
         }
 
         //remote solver
@@ -173,105 +1045,245 @@ namespace min2phase{ namespace http {
                               int8_t verbose, uint8_t* usedMoves,
                               std::string *time){
 
-            struct sockaddr_in sockAdd{};
-            struct hostent* sh;
-            int32_t client;
             std::stringstream ms;
-            std::string sol, tmp;
-            char msg[MSG_SIZE];
-
-            if ((sh = gethostbyname(ip.c_str())) == nullptr)
-                return "no host";
+            std::string sol, tmp, head, body;
+            const char* error;
+            bool reused, received = false;
 
-            memcpy(&sockAdd.sin_addr.s_addr, sh->h_addr, sh->h_length);
-            sockAdd.sin_port = htons(port);
-            sockAdd.sin_family = AF_INET;
+            //c=YYWOYYGBOGGOOBRWBGRRYOOWWRROWBOWWBYRRGYWGYYBBGRBGRGWBO&m=21&p=10000&P=0&v=1
+            ms << "GET /?c=" << facelets << "&m=" << (int32_t)maxDepth << "&p=" << probeMax << "&P=" << probeMin << "&v=" << (int32_t)verbose << " HTTP/1.1\r\nHost: " << ip << "\r\n\r\n";
+            tmp = ms.str();
 
-            client = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+            //a kept connection may have been closed by the server, it is opened again once
+            do {
+                reused = remote.fd >= 0 && remote.host == ip && remote.port == port;
 
-            if(client == -1)
-                return "no client";
+                if (!reused && (error = connectRemote(remote, ip, port)) != nullptr)
+                    return error;
 
-            if(connect(client, (struct sockaddr*)&sockAdd, sizeof(sockaddr_in)) == -1)
-                return "unable to connect";
+                received = send(remote.fd, tmp.c_str(), tmp.length(), MSG_NOSIGNAL) == (ssize_t) tmp.length() &&
+                           readResponse(head, body);
 
-            //c=YYWOYYGBOGGOOBRWBGRRYOOWWRROWBOWWBYRRGYWGYYBBGRBGRGWBO&m=21&p=10000&P=0&v=1
-            ms << "GET /c=" << facelets << "&m=" << (int32_t)maxDepth << "&p=" << probeMax << "&P=" << probeMin << "&v=" << (int32_t)verbose << " HTTP/1.1";
+                if (!received){
+                    close(remote.fd);
+                    remote.fd = -1;
+                }
+            } while (!received && reused);
 
-            tmp = ms.str();
-            write(client, tmp.c_str(), tmp.length());
+            if (!received)
+                return "no response";
 
-            memset((void*)msg, (int32_t)'\0', MSG_SIZE );
+            if (head.find("connection: close") != std::string::npos){
+                close(remote.fd);
+                remote.fd = -1;
+            }
 
-            if (recv(client, msg, MSG_SIZE, 0) > 0){
-                std::istringstream buf(msg);
+            if(head.compare(0, 15, "http/1.1 200 ok") == 0){
+                std::istringstream buf(body);
 
+                std::getline(buf, sol);
                 std::getline(buf, tmp);
 
-                if(tmp == "HTTP/1.1 200 OK"){
-                    std::getline(buf, tmp);
-                    std::getline(buf, sol);
-                    std::getline(buf, tmp);
+                if(usedMoves != nullptr){
+                    try{
+                        *usedMoves = std::stoi(tmp);
+                    }catch(std::invalid_argument &e){
+                        *usedMoves = -1;
+                    }
+                }
 
-                    if(usedMoves != nullptr){
-                        try{
-                            *usedMoves = std::stoi(tmp);
-                        }catch(std::invalid_argument &e){
-                            *usedMoves = -1;
-                        }
+                if(time != nullptr)
+                    std::getline(buf, *time);
+            }
+            else
+                sol = "error http";
+
+            return sol;
+        }
+
+        //send the cubes on the binary protocol and read their solutions, false if the connection failed
+        bool exchange(const std::vector<std::string>& cubes, binary::request_t frame,
+                      std::vector<RemoteSolution>& solutions){
+            char msg[MSG_SIZE];
+            std::string output;
+            RemoteSolution solution;
+            size_t next = 0, pending = 0, start, used;
+            uint32_t id;
+            ssize_t size;
+
+            binaryRemote.input.clear();
+
+            while (next < cubes.size() || pending > 0){
+                //the requests go ahead of the solutions, while the server has room for them
+                for (output.clear(); next < cubes.size() && pending < MAX_PIPELINE; next++){
+                    if (!tools::stateKey(cubes[next], frame.key)){
+                        solutions[next] = {tools::verify(cubes[next]), 0, {0}};
+                        continue;
                     }
 
-                    if(time != nullptr)
-                        std::getline(buf, *time);
+                    frame.id = (uint32_t) next;
+                    binary::writeRequest(frame, output);
+                    pending++;
+                }
+
+                if (!output.empty() &&
+                    send(binaryRemote.fd, output.data(), output.length(), MSG_NOSIGNAL) != (ssize_t) output.length())
+                    return false;
+
+                if (pending == 0)
+                    continue;
+
+                if ((size = recv(binaryRemote.fd, msg, MSG_SIZE, 0)) <= 0)
+                    return false;
+                binaryRemote.input.append(msg, (size_t) size);
+
+                for (start = 0; (used = binary::readResponse(binaryRemote.input, start, id, solution)) > 0; start += used){
+                    if (used == SIZE_MAX || id >= cubes.size())
+                        return false;
+
+                    solutions[id] = solution;
+                    pending--;
                 }
-                else
-                    sol = "error http";
+
+                binaryRemote.input.erase(0, start);
             }
-            else
-                sol = "no response";
 
+            return true;
+        }
 
-            shutdown(client, SHUT_RDWR);
-            close(client);
+        //remote solver on the binary protocol
+        bool binarySolver(const std::string& address, const std::vector<std::string>& cubes, int8_t maxDepth,
+                          int32_t probeMax, int32_t probeMin, int8_t verbose, std::vector<RemoteSolution>& solutions,
+                          uint32_t timeout){
+            const binary::request_t frame = {0, maxDepth, verbose, probeMax, probeMin, timeout, {0, 0}};
+            const size_t colon = address.rfind(':');
+            const bool isUnix = address.find('/') != std::string::npos || colon == std::string::npos;
+            const std::string host = isUnix ? address : address.substr(0, colon);
+            const int32_t port = isUnix ? -1 : std::atoi(address.c_str() + colon + 1);
+            bool reused, received;
 
-            return sol;
+            solutions.assign(cubes.size(), RemoteSolution{0, 0, {0}});
+
+            //a kept connection may have been closed by the server, it is opened again once
+            do {
+                reused = binaryRemote.fd >= 0 && binaryRemote.host == host && binaryRemote.port == port;
+
+                if (!reused && (isUnix ? connectUnix(binaryRemote, host) : connectRemote(binaryRemote, host, port)) != nullptr)
+                    return false;
+
+                received = exchange(cubes, frame, solutions);
+
+                if (!received){
+                    close(binaryRemote.fd);
+                    binaryRemote.fd = -1;
+                }
+            } while (!received && reused);
+
+            return received;
         }
 
         //start server
         bool init(uint16_t port, uint16_t mReq){
+            const uint32_t nWorkers = std::max(1u, std::thread::hardware_concurrency());
+
             if(server != nullptr)
                 return false;
 
-            signal(SIGCHLD, childCleaner);
-
             if(!startServer(std::to_string(port), mReq))
                 return false;
 
             isRunning = true;
+
+            maxQueue = QUEUE_PER_WORKER * nWorkers;
+
+            for (uint32_t i = 0; i < nWorkers; i++)
+                workers.emplace_back(worker);
+
+            pools::start(std::max(1u, nWorkers / 2));
+
             server = new std::thread(requestHandler);
 
             return true;
         }
 
+        //close the listening sockets of the binary protocol, false to return it from a failed listen
+        bool unlistenBinary(){
+            if (binaryfd >= 0){
+                epoll_ctl(epollfd, EPOLL_CTL_DEL, binaryfd, nullptr);
+                close(binaryfd);
+            }
+
+            if (unixfd >= 0){
+                epoll_ctl(epollfd, EPOLL_CTL_DEL, unixfd, nullptr);
+                close(unixfd);
+                unlink(unixPath.c_str());
+            }
+
+            binaryfd = unixfd = -1;
+
+            return false;
+        }
+
+        //listen for the binary protocol
+        bool listenBinary(uint16_t port, const std::string& path){
+            struct sockaddr_un address{};
+
+            if (!isRunning || binaryfd >= 0 || unixfd >= 0 || path.length() >= sizeof(address.sun_path))
+                return false;
+
+            if (port != 0 && ((binaryfd = listenTcp(std::to_string(port), backlog)) == -1 ||
+                              !watch(binaryfd, BINARY_ID, EPOLLIN)))
+                return unlistenBinary();
+
+            if (path.empty())
+                return true;
+
+            address.sun_family = AF_UNIX;
+            std::memcpy(address.sun_path, path.c_str(), path.length());
+
+            //the socket of a server that did not stop is still on the path
+            unlink(path.c_str());
+            unixPath = path;
+            unixfd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+
+            if (unixfd == -1 || bind(unixfd, (struct sockaddr*) &address, sizeof(address)) != 0 ||
+                listen(unixfd, backlog) != 0 || !watch(unixfd, UNIX_ID, EPOLLIN))
+                return unlistenBinary();
+
+            return true;
+        }
+
         //stop server
         bool stop(){
+            const uint64_t wake = 1;
+
             if(!isRunning)
                 return false;
 
-            isRunning = false;
+            {
+                std::lock_guard<std::mutex> lock(jobsLock);
+                isRunning = false;
+            }
+            jobsReady.notify_all();
 
-            if(shutdown(socketfd, SHUT_RDWR) != 0)
+            if (write(wakefd, &wake, sizeof(wake)) < 0)
                 return false;
 
             server->join();
             delete server;
-
-            if(close(socketfd) != 0)
-                return false;
-
             server = nullptr;
 
-            return true;
+            for (std::thread& w : workers)
+                w.join();
+            workers.clear();
+            pools::stop();
+            metrics::gauge(metrics::QUEUE_DEPTH, -(int64_t) jobs.size());
+            jobs.clear();
+            queued = 0;
+            done.clear();
+            unlistenBinary();
+
+            return close(socketfd) == 0 && close(epollfd) == 0 && close(wakefd) == 0;
         }
 }   }
 
@@ -287,6 +1299,16 @@ namespace min2phase{ namespace http{
         return "no supported device";
     }
 
+    bool binarySolver(const std::string& address, const std::vector<std::string>& cubes, int8_t maxDepth,
+                      int32_t probeMax, int32_t probeMin, int8_t verbose, std::vector<RemoteSolution>& solutions,
+                      uint32_t timeout){
+        return false;
+    }
+
+    bool listenBinary(uint16_t port, const std::string& path){
+        return false;
+    }
+
 
     bool init(uint16_t port, uint16_t mReq){
         return false;
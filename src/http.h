@@ -12,12 +12,15 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
+#include <min2phase/min2phase.h>
 
 namespace min2phase{ namespace http{
 
     /**
      * Remote cube solver. It connects form a remote cube solver server and
-     * ask the solution of the cube.
+     * ask the solution of the cube. The connection is kept open for the
+     * next requests of the same thread to the same server.
      *
      * @see: the local solver documentation
      *
@@ -38,12 +41,51 @@ namespace min2phase{ namespace http{
                           int8_t verbose, uint8_t* usedMoves,
                           std::string *time);
 
-
     /**
-     * This is used to init and http server.
+     * Remote cube solver on the binary protocol, see binary.h. The cubes
+     * are sent ahead of their solutions, up to the 64 requests that the
+     * server reads at a time on a connection. The connection is kept open
+     * for the next calls of the same thread to the same server.
      *
-     * @warning: this function will abilitate an handler for the zombie process,
-     *           do not register another handler with SIGCHLD.
+     * @param address   : "host:port" for TCP or the path of a Unix socket.
+     * @param cubes     : the cubes.
+     * @param maxDepth  : the max of moves used to solve a cube.
+     * @param probeMax  : the max of cube explored in phase 2.
+     * @param probeMin  : the min of cube explored in phase 2.
+     * @param verbose   : INVERSE_SOLUTION and OPTIMAL_SOLUTION are used.
+     * @param solutions : where to store the solutions, in the order of the cubes.
+     * @param timeout   : the time of a cube in milliseconds, 0 for the one of the server.
+     * @return          : false if the server could not be reached.
+     */
+    bool binarySolver(const std::string& address, const std::vector<std::string>& cubes, int8_t maxDepth,
+                      int32_t probeMax, int32_t probeMin, int8_t verbose, std::vector<RemoteSolution>& solutions,
+                      uint32_t timeout);
+
+    /**
+     * This is used to init and http server. An event loop thread accepts
+     * the connections and reads the requests, a pool of solver threads
+     * (one per core, each with its own search) computes the responses.
+     * The requests are HTTP GET: "/" answers "k", "/r" a random cube and
+     * "/?c=facelets&m=21&p=100000&P=0&v=0" the solution, the parameters
+     * but c can be left out. The connections are kept open and the
+     * requests can be pipelined, the responses come in their order.
+     * "POST /solve?m=21&p=100000&P=0&v=0" solves the cubes of the body,
+     * one per line or a JSON array of strings, on all the solver threads:
+     * the solutions are streamed with the chunked encoding as they are
+     * found, one line "index solution" per cube.
+     * "/ltct?target=X&twist=Y&n=N" streams N scrambles (default 1) of
+     * the LTCT case in the same way, one per line, each one checked
+     * against its cube (twist 'C' is no twist, see tools::validLtct):
+     * the scrambles of a case are made ahead in a pool. The solutions
+     * are cached, see serverCache. "/stats" shows the cache and the pools
+     * and "/metrics" the counters of the requests, the latency of the
+     * solves and the lengths of the solutions for Prometheus.
+     * A request has t milliseconds (default 10000) from when it is read:
+     * the searches stop at the deadline with the best solution found or
+     * with the error 10 (TIME_LIMIT), and also when the client goes away. The
+     * requests that need a solver thread are refused with 503 when 64
+     * jobs per thread are waiting. A batch counts as one request, it has
+     * at most one cube per thread waiting at a time.
      *
      * @param port      : the port of the server.
      * @pram mReq       : (Optional) the max number of requests.
@@ -52,7 +94,22 @@ namespace min2phase{ namespace http{
     extern bool init(uint16_t port, uint16_t mReq);
 
     /**
-     * This stops the solver server. It also remove the SIGCHLD signal handler.
+     * Serve also the binary protocol of binary.h, on a TCP port and on a
+     * Unix socket. Its requests are solves like "/?c=", on the same
+     * solver threads with the same cache, deadline and queue limit: a
+     * request refused because the queue is full has the status BUSY. The
+     * connections are pipelined like the HTTP ones.
+     *
+     * @param port      : the TCP port, 0 for none.
+     * @param path      : the path of the Unix socket, empty for none.
+     * @return          : false if the server is not running or a socket
+     *                    could not be opened.
+     */
+    extern bool listenBinary(uint16_t port, const std::string& path);
+
+    /**
+     * This stops the solver server and waits for its threads. The
+     * searches in progress are stopped and the queued requests dropped.
      *
      * @return          : true if it was done correctly, false if not.
      */
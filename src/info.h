@@ -86,6 +86,11 @@ namespace min2phase { namespace info {
      */
     const int8_t EDGE_ORI_CASES = 2;
 
+    /**
+     * This is the number of corner stickers, the targets from A to X.
+     */
+    const int8_t N_CORNER_STICKERS = 24;
+
     /**
      * This is the number of faces in the cube.
      */
@@ -252,8 +257,10 @@ namespace min2phase { namespace info {
 #define SHORT_DEPTH SHORT_DEPTH
         PROBE_LIMIT = 8, ///The limit of cube to explore is too low.
 #define PROBE_LIMIT PROBE_LIMIT
-        MISSING_COORDS = 9 ///The coordinates are not initialized.
+        MISSING_COORDS = 9, ///The coordinates are not initialized.
 #define MISSING_COORDS MISSING_COORDS
+        TIME_LIMIT = 10 ///The search reached its deadline or was cancelled.
+#define TIME_LIMIT TIME_LIMIT
     }Errors;
 
     /**
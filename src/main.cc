@@ -10,15 +10,62 @@
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <vector>
 
 #include "../include/min2phase/min2phase.h"
 #include "../include/min2phase/tools.h"
 #include "../include/cube.h"
+#include "../include/dedup.h"
+
+// False positive rate of the bloom filter: a new cube taken for a duplicate is
+// only generated again
+static const double BLOOM_FALSE_POSITIVE = 0.001;
+
+// Adds the rules of a constraints file, one per line, # starts a comment
+static bool read_constraints(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file) {
+        std::cout << "Cannot open the constraints file " << path << std::endl;
+        return false;
+    }
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+        if (!line.empty() && !min2phase::tools::addConstraint(line)) {
+            std::cout << "Invalid constraint " << line << " in " << path << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
 
 int main(int argc, char *argv[]){
     char target;
     char twist;
     int iterations;
+    std::string dedup = "exact";
+    //the constraints are the arguments that start with --, the others are positional
+    std::vector<char*> args;
+    for (int i = 0; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 14, "--constraints=") == 0) {
+            if (!read_constraints(arg.substr(14))) {
+                return 1;
+            }
+        } else if (arg.compare(0, 2, "--") == 0) {
+            if (!min2phase::tools::addConstraint(arg.substr(2))) {
+                std::cout << "Invalid constraint " << arg << std::endl;
+                return 1;
+            }
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    argc = (int) args.size();
+    argv = args.data();
     if (argc == 2) {
         target = argv[1][0];
         twist = 'C';
@@ -31,8 +78,17 @@ int main(int argc, char *argv[]){
         target = argv[1][0];
         twist = argv[2][0];
         iterations = std::stoi(argv[3]);
+    } else if (argc == 5) {
+        target = argv[1][0];
+        twist = argv[2][0];
+        iterations = std::stoi(argv[3]);
+        dedup = argv[4];
     } else {
-        std::cout << "Usage: " << argv[0] << " <parity_target> <corner_twist (leave blank for just parity)> <number_of_scrambles (optional)>" << std::endl;
+        std::cout << "Usage: " << argv[0] << " <parity_target> <corner_twist (leave blank for just parity)> <number_of_scrambles (optional)> <dedup: exact, bloom or none (optional)> [--constraint=min-max ...] [--constraints=file]" << std::endl;
+        return 1;
+    }
+    if (dedup != "exact" && dedup != "bloom" && dedup != "none") {
+        std::cout << "Unknown dedup " << dedup << ", use exact, bloom or none" << std::endl;
         return 1;
     }
     uint8_t movesUsed;
@@ -42,16 +98,45 @@ int main(int argc, char *argv[]){
     //min2phase::writeFile("coords.m2pc");
     int successes = 0;
     int counter = 0;
+    int duplicates = 0;
+    uint64_t key[2];
+    std::chrono::steady_clock::duration dedup_time{};
+    StateSet states(dedup == "exact" ? iterations : 0);
+    BloomFilter bloom(dedup == "bloom" ? iterations : 1, BLOOM_FALSE_POSITIVE);
     while (successes < iterations) {
         counter++;
-        std::string str = min2phase::solve(min2phase::tools::randomCube(target, twist), 28, 100000, 0, min2phase::INVERSE_SOLUTION, &movesUsed);
+        std::string facelets = min2phase::tools::randomCube(target, twist);
+        //the repeated states are skipped before the solve
+        auto start = std::chrono::steady_clock::now();
+        bool keyed = dedup != "none" && min2phase::tools::stateKey(facelets, key);
+        bool repeated = keyed && (dedup == "exact" ? states.contains(key) : bloom.contains(key));
+        dedup_time += std::chrono::steady_clock::now() - start;
+        if (repeated) {
+            duplicates++;
+            continue;
+        }
+        std::string str = min2phase::solve(facelets, 28, 100000, 0, min2phase::INVERSE_SOLUTION, &movesUsed);
         int double_moves = std::count(str.begin(), str.end(), '2');
         int moves = str.size() / 3;
         Cube cube{str};
         if (cube.check_ltct(target, twist)) {
             std::cout << str << std::endl;
             successes +=1;
+            start = std::chrono::steady_clock::now();
+            if (keyed && dedup == "exact") {
+                states.insert(key);
+            } else if (keyed) {
+                bloom.insert(key);
+            }
+            dedup_time += std::chrono::steady_clock::now() - start;
         }
     }
+    if (dedup != "none") {
+        std::cerr << "Dedup " << dedup << ": " << successes << " states, "
+                  << (dedup == "exact" ? states.memory() : bloom.memory()) << " bytes, "
+                  << duplicates << " duplicates, "
+                  << std::chrono::duration<double, std::nano>(dedup_time).count() / counter << " ns/cube" << std::endl;
+    }
+    std::cerr << min2phase::tools::constraintsReport();
     return 0;
 }
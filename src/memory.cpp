@@ -0,0 +1,235 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ */
+
+#include <min2phase/min2phase.h>
+#include "memory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace min2phase { namespace memory {
+
+    /**
+     * A region returned by allocate.
+     */
+    typedef struct region_s {
+        uint8_t* ptr;
+        size_t size;
+        Backing backing;
+    }region_t;
+
+    /**
+     * The list of the allocated regions. It is a function so it can be used
+     * from the static initialization of the tables.
+     *
+     * @return      : the regions.
+     */
+    static std::vector<region_t>& regions() {
+        static std::vector<region_t> list;
+        return list;
+    }
+
+    /**
+     * This indicates if the new regions must be moved on huge pages.
+     */
+    static bool useHuge = false;
+
+#ifdef __linux__
+
+    //round to 2MB
+    static size_t roundSize(size_t size) {
+        return (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+
+    /**
+     * Replace the pages of a region with a new mapping. The new mapping
+     * is filled with the content of the region and moved on its address,
+     * if something fails the region is not touched.
+     *
+     * @param r     : the region.
+     * @param flags : the flags of the new mapping.
+     * @return      : true if it was done, false if not.
+     */
+    static bool replace(const region_t& r, int32_t flags) {
+        void* ptr = mmap(nullptr, r.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+
+        if (ptr == MAP_FAILED)
+            return false;
+
+        std::memcpy(ptr, r.ptr, r.size);
+
+        if (mremap(ptr, r.size, r.size, MREMAP_MAYMOVE | MREMAP_FIXED, r.ptr) == MAP_FAILED) {
+            munmap(ptr, r.size);
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Set the advice of a region and fault its pages again, so the new pages
+     * follow the advice immediately instead of waiting for khugepaged.
+     *
+     * @param r      : the region.
+     * @param advice : MADV_HUGEPAGE or MADV_NOHUGEPAGE.
+     * @return       : true if the advice was accepted, false if not.
+     */
+    static bool refault(const region_t& r, int32_t advice) {
+        std::unique_ptr<uint8_t[]> copy;
+
+        if (madvise(r.ptr, r.size, advice) != 0)
+            return false;
+
+        copy.reset(new uint8_t[r.size]);
+        std::memcpy(copy.get(), r.ptr, r.size);
+        madvise(r.ptr, r.size, MADV_DONTNEED);
+        std::memcpy(r.ptr, copy.get(), r.size);
+
+        return true;
+    }
+
+    //move a region on huge or normal pages
+    static Backing remap(region_t& r, bool enable) {
+        if (enable) {
+            if (r.backing == HUGETLB || replace(r, MAP_HUGETLB))
+                return r.backing = HUGETLB;
+
+            r.backing = refault(r, MADV_HUGEPAGE) ? TRANSPARENT : SMALL_PAGES;
+        } else {
+            if (r.backing == HUGETLB && !replace(r, 0))
+                return r.backing;
+
+            refault(r, MADV_NOHUGEPAGE);
+            r.backing = SMALL_PAGES;
+        }
+
+        return r.backing;
+    }
+
+    //allocate a 2MB aligned region
+    void* allocate(size_t size) {
+        const size_t len = roundSize(size);
+        uint8_t *raw, *ptr;
+
+        raw = (uint8_t*) mmap(nullptr, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (raw == MAP_FAILED)
+            return nullptr;
+
+        ptr = (uint8_t*) (((uintptr_t) raw + HUGE_PAGE_SIZE - 1) & ~(uintptr_t) (HUGE_PAGE_SIZE - 1));
+
+        if (ptr != raw)
+            munmap(raw, ptr - raw);
+
+        if (ptr + len != raw + len + HUGE_PAGE_SIZE)
+            munmap(ptr + len, raw + HUGE_PAGE_SIZE - ptr);
+
+        regions().push_back({ptr, len, SMALL_PAGES});
+
+        if (useHuge)
+            remap(regions().back(), true);
+
+        return ptr;
+    }
+
+    //release a region
+    void release(void* ptr) {
+        std::vector<region_t>& list = regions();
+
+        for (auto it = list.begin(); it != list.end(); it++) {
+            if (it->ptr == ptr) {
+                munmap(it->ptr, it->size);
+                list.erase(it);
+                return;
+            }
+        }
+    }
+
+    //drop the pages of a table
+    void discard(void* ptr, size_t size) {
+        const uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+        const uintptr_t begin = ((uintptr_t) ptr + page - 1) & ~(page - 1);
+        const uintptr_t end = ((uintptr_t) ptr + size) & ~(page - 1);
+
+        if (begin >= end) {
+            std::memset(ptr, 0, size);
+            return;
+        }
+
+        std::memset(ptr, 0, begin - (uintptr_t) ptr);
+        std::memset((void*) end, 0, (uintptr_t) ptr + size - end);
+
+        if (madvise((void*) begin, end - begin, MADV_DONTNEED) != 0)
+            std::memset((void*) begin, 0, end - begin);
+    }
+
+#else
+
+    //allocate a region
+    void* allocate(size_t size) {
+        uint8_t* ptr = new uint8_t[size]();
+
+        regions().push_back({ptr, size, SMALL_PAGES});
+
+        return ptr;
+    }
+
+    //release a region
+    void release(void* ptr) {
+        std::vector<region_t>& list = regions();
+
+        for (auto it = list.begin(); it != list.end(); it++) {
+            if (it->ptr == ptr) {
+                delete[] it->ptr;
+                list.erase(it);
+                return;
+            }
+        }
+    }
+
+    //clear a table
+    void discard(void* ptr, size_t size) {
+        std::memset(ptr, 0, size);
+    }
+
+    //no huge pages
+    static Backing remap(region_t& r, bool enable) {
+        return SMALL_PAGES;
+    }
+
+#endif
+
+    //move all the regions
+    Backing hugePages(bool enable) {
+        MIN2PHASE_OUTPUT(enable ? "Moving tables on huge pages." : "Moving tables on normal pages.")
+
+        useHuge = enable;
+
+        for (region_t& r : regions())
+            remap(r, enable);
+
+        return backing();
+    }
+
+    //get the pages type
+    Backing backing() {
+        Backing b = HUGETLB;
+
+        for (const region_t& r : regions())
+            b = std::min(b, r.backing);
+
+        return regions().empty() ? SMALL_PAGES : b;
+    }
+} }
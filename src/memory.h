@@ -0,0 +1,82 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the allocator used for the move and pruning tables.
+ * The tables are bigger than a megabyte and the search reads them at
+ * random, so every lookup can miss the TLB. The memory returned by this
+ * allocator is aligned to 2 MB and can be moved on huge pages, one 2 MB
+ * page covers what would need 512 normal pages.
+ */
+
+#ifndef MIN2PHASE_MEMORY_H
+#define MIN2PHASE_MEMORY_H 1
+
+#include <cstddef>
+#include <cstdint>
+
+namespace min2phase { namespace memory {
+
+    /**
+     * The size of a huge page.
+     */
+    const size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+
+    /**
+     * The type of pages used for the tables.
+     */
+    typedef enum : int8_t {
+        SMALL_PAGES = 0, ///Normal 4 KB pages.
+        TRANSPARENT = 1, ///Transparent huge pages requested with madvise.
+        HUGETLB = 2      ///Explicit huge pages from the hugetlbfs pool.
+    }Backing;
+
+    /**
+     * Allocate a zeroed region for a table. The region starts on a 2 MB
+     * boundary and its size is rounded up to a multiple of 2 MB, so it
+     * can be moved on huge pages without changing its address.
+     *
+     * @param size  : the size in bytes.
+     * @return      : the pointer to the region, nullptr if it fails.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * Release a region returned by allocate.
+     *
+     * @param ptr   : the pointer to the region.
+     */
+    void release(void* ptr);
+
+    /**
+     * Give back to the system the pages inside a table that is not used,
+     * so they do not count in the resident memory. The table reads as zero
+     * after it. On systems without mmap it does nothing.
+     *
+     * @param ptr   : the start of the table.
+     * @param size  : the size in bytes of the table.
+     */
+    void discard(void* ptr, size_t size);
+
+    /**
+     * Move all the allocated regions on huge pages or back on normal pages.
+     * The content and the address of the regions are kept. It first tries
+     * an explicit hugetlbfs mapping and falls back to transparent huge pages.
+     * Do not call it while a solver is reading the tables.
+     *
+     * @param enable : true to use huge pages, false to use normal pages.
+     * @return       : the type of pages used now.
+     */
+    Backing hugePages(bool enable);
+
+    /**
+     * Get the type of pages used for the regions.
+     *
+     * @return       : the type of pages.
+     */
+    Backing backing();
+} }
+
+#endif //MIN2PHASE_MEMORY_H
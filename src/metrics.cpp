@@ -0,0 +1,340 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+#include "cache.h"
+#include "metrics.h"
+#include "pools.h"
+
+namespace min2phase { namespace metrics {
+
+    /**
+     * The size of a cache line, the blocks of two threads are on different
+     * lines.
+     */
+    static const uint8_t CACHE_LINE = 64;
+
+    /**
+     * The most buckets of a histogram, the last one is +Inf.
+     */
+    static const uint8_t MAX_BUCKETS = 16;
+
+    /**
+     * The histograms.
+     */
+    typedef enum histogram_e {
+        LATENCY,
+        MOVES,
+        PROBES,
+        N_HISTOGRAMS
+    }histogram_t;
+
+    /**
+     * A histogram: its name, its help, the upper bounds of the buckets and
+     * the scale of the values in the text (the latency is counted in
+     * microseconds and written in seconds).
+     */
+    typedef struct layout_s {
+        const char* name;
+        const char* help;
+        uint64_t bounds[MAX_BUCKETS - 1];
+        uint8_t nBounds;
+        double scale;
+    }layout_t;
+
+    static const layout_t LAYOUTS[N_HISTOGRAMS] = {
+            {"min2phase_solve_seconds", "The time of the solves, with the ones taken from the cache.",
+             {250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000}, 13, 1e-6},
+            {"min2phase_solution_moves", "The length of the solutions.",
+             {12, 16, 17, 18, 19, 20, 21, 22, 23, 24, 31}, 11, 1},
+            {"min2phase_search_probes", "The cubes explored in phase 2 by a search.",
+             {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000}, 8, 1}
+    };
+
+    static const char* ENDPOINTS[N_ENDPOINTS] = {"ping", "solve", "random", "batch", "ltct", "stats", "metrics",
+                                                 "binary", "invalid"};
+
+    static const char* SHEDS[N_SHEDS] = {"queue_full", "deadline", "disconnected"};
+
+    /**
+     * The counts of a histogram, one for each bucket (not cumulative) and
+     * the sum of the values.
+     */
+    typedef struct counts_s {
+        std::atomic<uint64_t> buckets[MAX_BUCKETS];
+        std::atomic<uint64_t> sum;
+    }counts_t;
+
+    /**
+     * The counters of a thread, only that thread writes them.
+     */
+    typedef struct block_s {
+        std::atomic<uint64_t> requests[N_ENDPOINTS];
+        std::atomic<int64_t> gauges[N_GAUGES];
+        std::atomic<uint64_t> sheds[N_SHEDS];
+        std::atomic<uint64_t> expired;
+        counts_t histograms[N_HISTOGRAMS];
+        char pad[CACHE_LINE];
+    }block_t;
+
+    /**
+     * The blocks of all the threads and the ones of the threads that ended.
+     */
+    static std::mutex blocksLock;
+    static std::vector<block_t*> blocks;
+    static std::vector<block_t*> unused;
+
+    /**
+     * The block of a thread, given back when the thread ends.
+     */
+    typedef struct owner_s {
+        block_t* block;
+
+        ~owner_s() {
+            if (block == nullptr)
+                return;
+
+            std::lock_guard<std::mutex> lock(blocksLock);
+            unused.push_back(block);
+        }
+    }owner_t;
+
+    static thread_local owner_t owner = {nullptr};
+
+    //the block of this thread, the first count takes it
+    static block_t& local() {
+        if (owner.block != nullptr)
+            return *owner.block;
+
+        std::lock_guard<std::mutex> lock(blocksLock);
+
+        if (unused.empty()) {
+            owner.block = new block_t();
+            blocks.push_back(owner.block);
+        } else {
+            owner.block = unused.back();
+            unused.pop_back();
+        }
+
+        return *owner.block;
+    }
+
+    //add to a counter of this thread: nobody else writes it
+    template<typename T>
+    static void add(std::atomic<T>& counter, T value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    //count a value in its bucket
+    static void observe(histogram_t histogram, uint64_t value) {
+        const layout_t& layout = LAYOUTS[histogram];
+        counts_t& counts = local().histograms[histogram];
+        uint8_t i = 0;
+
+        while (i < layout.nBounds && value > layout.bounds[i])
+            i++;
+
+        add<uint64_t>(counts.buckets[i], 1);
+        add<uint64_t>(counts.sum, value);
+    }
+
+    //count a request
+    void request(endpoint_t endpoint) {
+        add<uint64_t>(local().requests[endpoint], 1);
+    }
+
+    //move a gauge
+    void gauge(gauge_t gauge, int64_t delta) {
+        add<int64_t>(local().gauges[gauge], delta);
+    }
+
+    //count a request that is not done
+    void shed(shed_t reason) {
+        add<uint64_t>(local().sheds[reason], 1);
+    }
+
+    //count a solve
+    void solve(uint64_t micros, uint8_t moves) {
+        observe(LATENCY, micros);
+        observe(MOVES, moves);
+    }
+
+    //count a search
+    void search(uint64_t probes, bool expired) {
+        observe(PROBES, probes);
+
+        if (expired)
+            add<uint64_t>(local().expired, 1);
+    }
+
+    //the head of a metric
+    static void head(std::string& text, const char* name, const char* help, const char* type) {
+        text += "# HELP ";
+        text += name;
+        text += " ";
+        text += help;
+        text += "\n# TYPE ";
+        text += name;
+        text += " ";
+        text += type;
+        text += "\n";
+    }
+
+    //a line of a metric
+    static void sample(std::string& text, const char* name, const char* labels, double value) {
+        char line[256];
+
+        std::snprintf(line, sizeof(line), "%s%s %.15g\n", name, labels, value);
+        text += line;
+    }
+
+    //the cumulative buckets, the sum and the count of a histogram
+    static void histogram(std::string& text, const layout_t& layout, const uint64_t* buckets, uint64_t sum) {
+        char name[128], labels[64];
+        uint64_t count = 0;
+        uint8_t i;
+
+        head(text, layout.name, layout.help, "histogram");
+        std::snprintf(name, sizeof(name), "%s_bucket", layout.name);
+
+        for (i = 0; i <= layout.nBounds; i++) {
+            count += buckets[i];
+
+            if (i < layout.nBounds)
+                std::snprintf(labels, sizeof(labels), "{le=\"%.15g\"}", layout.bounds[i] * layout.scale);
+            else
+                std::snprintf(labels, sizeof(labels), "{le=\"+Inf\"}");
+
+            sample(text, name, labels, (double) count);
+        }
+
+        std::snprintf(name, sizeof(name), "%s_sum", layout.name);
+        sample(text, name, "", sum * layout.scale);
+        std::snprintf(name, sizeof(name), "%s_count", layout.name);
+        sample(text, name, "", (double) count);
+    }
+
+    //sum the blocks of the threads, then the cache and the pools
+    std::string text() {
+        static const char* GAUGES[N_GAUGES][2] = {
+                {"min2phase_connections", "The open connections."},
+                {"min2phase_requests_in_flight", "The requests read and not answered yet."},
+                {"min2phase_queue_depth", "The jobs waiting for a worker."},
+                {"min2phase_busy_workers", "The workers that are solving."}
+        };
+        uint64_t requests[N_ENDPOINTS] = {0}, buckets[N_HISTOGRAMS][MAX_BUCKETS] = {{0}}, sums[N_HISTOGRAMS] = {0};
+        uint64_t sheds[N_SHEDS] = {0}, expired = 0;
+        int64_t gauges[N_GAUGES] = {0};
+        const cache::counters_t solutions = cache::counters();
+        std::string text;
+        char labels[64];
+        uint8_t i, j;
+
+        {
+            std::lock_guard<std::mutex> lock(blocksLock);
+
+            for (const block_t* block : blocks) {
+                for (i = 0; i < N_ENDPOINTS; i++)
+                    requests[i] += block->requests[i].load(std::memory_order_relaxed);
+
+                for (i = 0; i < N_GAUGES; i++)
+                    gauges[i] += block->gauges[i].load(std::memory_order_relaxed);
+
+                for (i = 0; i < N_SHEDS; i++)
+                    sheds[i] += block->sheds[i].load(std::memory_order_relaxed);
+
+                expired += block->expired.load(std::memory_order_relaxed);
+
+                for (i = 0; i < N_HISTOGRAMS; i++) {
+                    for (j = 0; j < MAX_BUCKETS; j++)
+                        buckets[i][j] += block->histograms[i].buckets[j].load(std::memory_order_relaxed);
+
+                    sums[i] += block->histograms[i].sum.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        head(text, "min2phase_requests_total", "The requests read by the server.", "counter");
+
+        for (i = 0; i < N_ENDPOINTS; i++) {
+            std::snprintf(labels, sizeof(labels), "{endpoint=\"%s\"}", ENDPOINTS[i]);
+            sample(text, "min2phase_requests_total", labels, (double) requests[i]);
+        }
+
+        head(text, "min2phase_shed_total", "The requests and the jobs of the batches that were not done.", "counter");
+
+        for (i = 0; i < N_SHEDS; i++) {
+            std::snprintf(labels, sizeof(labels), "{reason=\"%s\"}", SHEDS[i]);
+            sample(text, "min2phase_shed_total", labels, (double) sheds[i]);
+        }
+
+        head(text, "min2phase_searches_expired_total", "The searches stopped by their deadline or by their client.",
+             "counter");
+        sample(text, "min2phase_searches_expired_total", "", (double) expired);
+
+        for (i = 0; i < N_GAUGES; i++) {
+            head(text, GAUGES[i][0], GAUGES[i][1], "gauge");
+            sample(text, GAUGES[i][0], "", (double) gauges[i]);
+        }
+
+        for (i = 0; i < N_HISTOGRAMS; i++)
+            histogram(text, LAYOUTS[i], buckets[i], sums[i]);
+
+        head(text, "min2phase_cache_entries", "The solutions in the cache.", "gauge");
+        sample(text, "min2phase_cache_entries", "", (double) solutions.entries);
+        head(text, "min2phase_cache_bytes", "The bytes of the solutions in the cache.", "gauge");
+        sample(text, "min2phase_cache_bytes", "", (double) solutions.bytes);
+        head(text, "min2phase_cache_limit_bytes", "The limit of the bytes of the cache.", "gauge");
+        sample(text, "min2phase_cache_limit_bytes", "", (double) solutions.limit);
+        head(text, "min2phase_cache_requests_total", "The solves of valid cubes by the way they were answered.",
+             "counter");
+        sample(text, "min2phase_cache_requests_total", "{result=\"hit\"}", (double) solutions.hits);
+        sample(text, "min2phase_cache_requests_total", "{result=\"miss\"}", (double) solutions.misses);
+        sample(text, "min2phase_cache_requests_total", "{result=\"coalesced\"}", (double) solutions.coalesced);
+        head(text, "min2phase_cache_evictions_total", "The solutions removed to stay in the limit.", "counter");
+        sample(text, "min2phase_cache_evictions_total", "", (double) solutions.evictions);
+
+        const std::vector<pools::counters_t> all = pools::counters();
+
+        if (all.empty())
+            return text;
+
+        head(text, "min2phase_pool_scrambles", "The LTCT scrambles ready in a pool.", "gauge");
+        for (const pools::counters_t& pool : all) {
+            std::snprintf(labels, sizeof(labels), "{target=\"%c\",twist=\"%c\"}", pool.target, pool.twist);
+            sample(text, "min2phase_pool_scrambles", labels, pool.size);
+        }
+
+        head(text, "min2phase_pool_requests_total", "The scrambles asked to a pool by the way they were answered.",
+             "counter");
+        for (const pools::counters_t& pool : all) {
+            std::snprintf(labels, sizeof(labels), "{target=\"%c\",twist=\"%c\",result=\"hit\"}", pool.target,
+                          pool.twist);
+            sample(text, "min2phase_pool_requests_total", labels, (double) pool.hits);
+            std::snprintf(labels, sizeof(labels), "{target=\"%c\",twist=\"%c\",result=\"miss\"}", pool.target,
+                          pool.twist);
+            sample(text, "min2phase_pool_requests_total", labels, (double) pool.misses);
+        }
+
+        head(text, "min2phase_pool_refills_total", "The refills of a pool up to the high watermark.", "counter");
+        for (const pools::counters_t& pool : all) {
+            std::snprintf(labels, sizeof(labels), "{target=\"%c\",twist=\"%c\"}", pool.target, pool.twist);
+            sample(text, "min2phase_pool_refills_total", labels, (double) pool.refills);
+        }
+
+        head(text, "min2phase_pool_refill_lag_seconds", "The time of the last refill of a pool.", "gauge");
+        for (const pools::counters_t& pool : all) {
+            std::snprintf(labels, sizeof(labels), "{target=\"%c\",twist=\"%c\"}", pool.target, pool.twist);
+            sample(text, "min2phase_pool_refill_lag_seconds", labels, pool.lag * 1e-6);
+        }
+
+        return text;
+    }
+} }
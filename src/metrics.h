@@ -0,0 +1,110 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the metrics of the server in the text format of
+ * Prometheus. Every thread counts in its own block of counters, written only
+ * by that thread without atomic read-modify-write, so counting is a load and
+ * a store on a line that no other thread writes. A scrape sums the blocks of
+ * all the threads; the block of a thread that ends is kept with its counts
+ * and taken by the next thread.
+ */
+
+#ifndef MIN2PHASE_METRICS_H
+#define MIN2PHASE_METRICS_H 1
+
+#include <cstdint>
+#include <string>
+
+namespace min2phase { namespace metrics {
+
+    /**
+     * The kinds of request of the server.
+     */
+    typedef enum endpoint_e {
+        PING,
+        SOLVE,
+        RANDOM,
+        BATCH,
+        LTCT,
+        STATS,
+        METRICS,
+        BINARY,
+        INVALID,
+        N_ENDPOINTS
+    }endpoint_t;
+
+    /**
+     * The gauges: the open connections, the requests read and not answered
+     * yet, the jobs waiting for a worker and the workers that are busy.
+     */
+    typedef enum gauge_e {
+        CONNECTIONS,
+        IN_FLIGHT,
+        QUEUE_DEPTH,
+        BUSY_WORKERS,
+        N_GAUGES
+    }gauge_t;
+
+    /**
+     * The reasons a request is not done: the queue of the workers is full,
+     * its deadline passed while it waited or its client went away.
+     */
+    typedef enum shed_e {
+        QUEUE_FULL,
+        DEADLINE,
+        DISCONNECTED,
+        N_SHEDS
+    }shed_t;
+
+    /**
+     * Count a request.
+     *
+     * @param endpoint  : the kind of the request.
+     */
+    void request(endpoint_t endpoint);
+
+    /**
+     * Move a gauge. A gauge is the sum of the moves of all the threads, so
+     * a thread can take away what another one added.
+     *
+     * @param gauge     : the gauge.
+     * @param delta     : the value added to the gauge.
+     */
+    void gauge(gauge_t gauge, int64_t delta);
+
+    /**
+     * Count a request, or a job of a batch, that is not done.
+     *
+     * @param reason    : why it is not done.
+     */
+    void shed(shed_t reason);
+
+    /**
+     * Count a solve of a valid cube, searched or taken from the cache.
+     *
+     * @param micros    : the time of the solve in microseconds.
+     * @param moves     : the length of the solution.
+     */
+    void solve(uint64_t micros, uint8_t moves);
+
+    /**
+     * Count a search.
+     *
+     * @param probes    : the cubes explored in phase 2.
+     * @param expired   : true if the budget of the search stopped it.
+     */
+    void search(uint64_t probes, bool expired);
+
+    /**
+     * Get the metrics of the server with the ones of the cache and of the
+     * pools.
+     *
+     * @return          : the metrics in the text format of Prometheus.
+     */
+    std::string text();
+} }
+
+#endif //MIN2PHASE_METRICS_H
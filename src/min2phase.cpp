@@ -5,17 +5,25 @@
  * under certain conditions; type `show c' for details.
  */
 
-#include <fstream>
 #include <min2phase/min2phase.h>
 #include "Search.h"
+#include "cache.h"
 #include "http.h"
+#include "memory.h"
+#include "storage.h"
 
 namespace min2phase {
 
     //initialization
-    void init() {
+    void init(Profile profile) {
         info::init();
-        coords::init();
+        coords::init(profile);
+    }
+
+    //progressive initialization
+    void initAsync(Profile profile) {
+        info::init();
+        coords::initAsync(profile);
     }
 
     //write coords
@@ -23,37 +31,36 @@ namespace min2phase {
         if(!coords::isInit())
             init();
 
-        std::ofstream out(name);
+        coords::wait();
 
         MIN2PHASE_OUTPUT("Writing file.")
 
-        if(out) {
-            out.write(reinterpret_cast<char *>(&coords::coords), sizeof(coords::coords_t));
-            out.close();
-            return true;
-        }
-
-        return false;
+        return storage::write(name, coords::getProfile());
     }
 
     //load coords
-    bool loadFile(const std::string& name){
-        std::ifstream in(name);
-
+    bool loadFile(const std::string& name, Profile profile){
         MIN2PHASE_OUTPUT("Loading file.")
 
-        if(in){
-            in.read(reinterpret_cast<char*>(&coords::coords), sizeof(coords::coords_t));
-            in.close();
+        coords::wait();
+
+        if(storage::read(name, profile)){
             info::init();
+            coords::setComplete(profile);
             return true;
         }
         else
-            init();
+            initAsync(profile);
 
         return false;
     }
 
+    //move tables on huge pages
+    bool hugePages(bool enable){
+        coords::wait();
+        return memory::hugePages(enable) != memory::SMALL_PAGES;
+    }
+
     //solve the cube
     std::string solve(const std::string &facelets, int8_t maxDepth, int32_t probeMax, int32_t probeMin,
                                      int8_t verbose, uint8_t* usedMoves) {
@@ -66,6 +73,16 @@ namespace min2phase {
         return http::init(port, mReq);
     }
 
+    //binary protocol of the server
+    bool serverBinary(uint16_t port, const std::string& path){
+        return http::listenBinary(port, path);
+    }
+
+    //memory of the solutions of the server
+    void serverCache(size_t bytes){
+        cache::setLimit(bytes);
+    }
+
     //stop solver
     bool stop(){
         return http::stop();
@@ -80,4 +97,11 @@ namespace min2phase {
 
         return http::webSolver(ip, port, facelets, maxDepth, probeMax, probeMin, verbose, usedMoves, time);
     }
+
+    //remote search on the binary protocol
+    bool binarySearch(const std::string& address, const std::vector<std::string>& cubes, int8_t maxDepth,
+                      int32_t probeMax, int32_t probeMin, int8_t verbose, std::vector<RemoteSolution>& solutions,
+                      uint32_t timeout){
+        return http::binarySolver(address, cubes, maxDepth, probeMax, probeMin, verbose, solutions, timeout);
+    }
 }
@@ -0,0 +1,293 @@
+#include "../include/packed_cube.h"
+#include "../include/turns.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PACKED_CUBE_X86
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define PACKED_CUBE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+    // Number of bytes of a 128 bits register
+    constexpr int BLOCK = 16;
+
+    // Number of 128 bits registers of the state
+    constexpr int N_BLOCKS = PackedCube::SIZE / BLOCK;
+
+    // Source sticker of every sticker after each turn
+    struct MoveTable {
+        alignas(PackedCube::SIZE) uint8_t source[Turns::N_MOVES][PackedCube::SIZE];
+    };
+
+    // Builds the permutation of every turn from the cycles of the faces
+    constexpr MoveTable make_move_table() {
+        MoveTable table{};
+
+        for (int move = 0; move < Turns::N_MOVES; move++) {
+            const int shift = move % 3 + 1;
+
+            for (int i = 0; i < PackedCube::SIZE; i++) {
+                table.source[move][i] = (uint8_t) i;
+            }
+            for (int i = 0; i < Turns::N_CYCLES; i++) {
+                for (int j = 0; j < 4; j++) {
+                    table.source[move][Turns::CYCLES[move / 3][i][j]] = Turns::CYCLES[move / 3][i][(j + shift) & 3];
+                }
+            }
+        }
+
+        return table;
+    }
+
+    constexpr MoveTable MOVE_TABLE = make_move_table();
+
+#ifndef PACKED_CUBE_NEON
+    // Rotates the sticker cycles of the face, only the 20 moved stickers are touched
+    void turn_scalar(uint8_t* state, int move) {
+        const int shift = move % 3 + 1;
+        uint8_t values[4];
+
+        for (const auto& cycle : Turns::CYCLES[move / 3]) {
+            for (int j = 0; j < 4; j++) {
+                values[j] = state[cycle[j]];
+            }
+            for (int j = 0; j < 4; j++) {
+                state[cycle[j]] = values[(j + shift) & 3];
+            }
+        }
+    }
+
+    // Moves every byte to its place with a gather
+    void permute_scalar(uint8_t* state, const uint8_t* source) {
+        uint8_t next[PackedCube::SIZE];
+
+        for (int i = 0; i < PackedCube::SIZE; i++) {
+            next[i] = state[source[i]];
+        }
+        std::memcpy(state, next, PackedCube::SIZE);
+    }
+#endif
+
+#ifdef PACKED_CUBE_X86
+    // One vpermb moves all the 64 bytes
+    __attribute__((target("avx512f,avx512vbmi")))
+    void permute_vbmi(uint8_t* state, const uint8_t* source) {
+        const __m512i stickers = _mm512_load_si512(state);
+
+        _mm512_store_si512(state, _mm512_maskz_permutexvar_epi8(~(__mmask64) 0, _mm512_load_si512(source), stickers));
+    }
+
+    // pshufb only shuffles inside a register: the index minus the first byte
+    // of the register is valid only for the bytes of that register, the
+    // others get the high bit set and are cleared
+    __attribute__((target("ssse3")))
+    inline __m128i shuffle_block(__m128i stickers, __m128i index) {
+        return _mm_shuffle_epi8(stickers, _mm_or_si128(index, _mm_cmpgt_epi8(index, _mm_set1_epi8(BLOCK - 1))));
+    }
+
+    // Every output register is the or of the shuffles of the four input registers
+    __attribute__((target("ssse3")))
+    void permute_ssse3(uint8_t* state, const uint8_t* source) {
+        __m128i* blocks = reinterpret_cast<__m128i*>(state);
+        const __m128i step = _mm_set1_epi8(BLOCK);
+        const __m128i stickers0 = _mm_load_si128(blocks), stickers1 = _mm_load_si128(blocks + 1);
+        const __m128i stickers2 = _mm_load_si128(blocks + 2), stickers3 = _mm_load_si128(blocks + 3);
+        __m128i index0, index1, index2, index3;
+
+        for (int i = 0; i < N_BLOCKS; i++) {
+            index0 = _mm_load_si128(reinterpret_cast<const __m128i*>(source) + i);
+            index1 = _mm_sub_epi8(index0, step);
+            index2 = _mm_sub_epi8(index1, step);
+            index3 = _mm_sub_epi8(index2, step);
+            _mm_store_si128(blocks + i, _mm_or_si128(
+                    _mm_or_si128(shuffle_block(stickers0, index0), shuffle_block(stickers1, index1)),
+                    _mm_or_si128(shuffle_block(stickers2, index2), shuffle_block(stickers3, index3))));
+        }
+    }
+
+    // The masks of the turns are known: every output register is the or of
+    // the shuffles of the input registers, 0x80 clears the bytes taken from
+    // the other registers
+    struct ShuffleTable {
+        alignas(BLOCK) uint8_t mask[Turns::N_MOVES][N_BLOCKS][N_BLOCKS][BLOCK];
+    };
+
+    // Splits the permutation of every turn in the masks of the registers
+    constexpr ShuffleTable make_shuffle_table() {
+        ShuffleTable table{};
+
+        for (int move = 0; move < Turns::N_MOVES; move++) {
+            for (int i = 0; i < PackedCube::SIZE; i++) {
+                const int source = MOVE_TABLE.source[move][i];
+
+                for (int j = 0; j < N_BLOCKS; j++) {
+                    table.mask[move][i / BLOCK][j][i % BLOCK] = source / BLOCK == j ? source % BLOCK : 0x80;
+                }
+            }
+        }
+
+        return table;
+    }
+
+    constexpr ShuffleTable SHUFFLE_TABLE = make_shuffle_table();
+
+    // Four pshufb with the masks of the turn for every 16 bytes
+    __attribute__((target("ssse3")))
+    void turn_ssse3(uint8_t* state, int move) {
+        __m128i* blocks = reinterpret_cast<__m128i*>(state);
+        const __m128i* mask = reinterpret_cast<const __m128i*>(SHUFFLE_TABLE.mask[move]);
+        const __m128i stickers0 = _mm_load_si128(blocks), stickers1 = _mm_load_si128(blocks + 1);
+        const __m128i stickers2 = _mm_load_si128(blocks + 2), stickers3 = _mm_load_si128(blocks + 3);
+
+        for (int i = 0; i < N_BLOCKS; i++, mask += N_BLOCKS) {
+            _mm_store_si128(blocks + i, _mm_or_si128(
+                    _mm_or_si128(_mm_shuffle_epi8(stickers0, _mm_load_si128(mask)), _mm_shuffle_epi8(stickers1, _mm_load_si128(mask + 1))),
+                    _mm_or_si128(_mm_shuffle_epi8(stickers2, _mm_load_si128(mask + 2)), _mm_shuffle_epi8(stickers3, _mm_load_si128(mask + 3)))));
+        }
+    }
+
+    // One vpermb with the permutation of the turn
+    __attribute__((target("avx512f,avx512vbmi")))
+    void turn_vbmi(uint8_t* state, int move) {
+        permute_vbmi(state, MOVE_TABLE.source[move]);
+    }
+
+    // Chooses the best turn for the cpu
+    void (*select_turn())(uint8_t*, int) {
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512vbmi")) {
+            return turn_vbmi;
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+            return turn_ssse3;
+        }
+
+        return turn_scalar;
+    }
+
+    // Chooses the best permutation for the cpu
+    void (*select_permute())(uint8_t*, const uint8_t*) {
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512vbmi")) {
+            return permute_vbmi;
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+            return permute_ssse3;
+        }
+
+        return permute_scalar;
+    }
+#endif
+
+#ifdef PACKED_CUBE_NEON
+    // One tbl of the four registers for every 16 bytes
+    void permute_neon(uint8_t* state, const uint8_t* source) {
+        uint8x16x4_t stickers;
+
+        stickers.val[0] = vld1q_u8(state);
+        stickers.val[1] = vld1q_u8(state + BLOCK);
+        stickers.val[2] = vld1q_u8(state + 2 * BLOCK);
+        stickers.val[3] = vld1q_u8(state + 3 * BLOCK);
+        for (int i = 0; i < N_BLOCKS; i++) {
+            vst1q_u8(state + i * BLOCK, vqtbl4q_u8(stickers, vld1q_u8(source + i * BLOCK)));
+        }
+    }
+#endif
+
+    // Moves the bytes of the state: state[i] takes the value at state[source[i]]
+    void permute(uint8_t* state, const uint8_t* source) {
+#if defined(PACKED_CUBE_X86)
+        static void (*const permute_cpu)(uint8_t*, const uint8_t*) = select_permute();
+
+        permute_cpu(state, source);
+#elif defined(PACKED_CUBE_NEON)
+        permute_neon(state, source);
+#else
+        permute_scalar(state, source);
+#endif
+    }
+}
+
+// Default constructor: Initializes the solved state
+PackedCube::PackedCube() {
+    for (int i = 0; i < SIZE; i++) {
+        state[i] = (uint8_t) i;
+    }
+}
+
+// Conversion constructor: Copies the stickers of the cube
+PackedCube::PackedCube(const Cube& cube) : PackedCube() {
+    const std::array<unsigned short, 54> stickers = cube.get_state();
+
+    for (int i = 0; i < 54; i++) {
+        state[i] = (uint8_t) stickers[i];
+    }
+}
+
+// Parameter constructor: Composes the turns of the scramble
+PackedCube::PackedCube(const std::string& scramble) : PackedCube() {
+    scramble_cube(scramble);
+}
+
+// Moves all the stickers with the permutation of the turn
+void PackedCube::turn(int move) {
+#if defined(PACKED_CUBE_X86)
+    static void (*const turn_cpu)(uint8_t*, int) = select_turn();
+
+    turn_cpu(state.data(), move);
+#elif defined(PACKED_CUBE_NEON)
+    permute_neon(state.data(), MOVE_TABLE.source[move]);
+#else
+    turn_scalar(state.data(), move);
+#endif
+}
+
+// Scrambler of the cube: a malformed scramble restores the previous state
+bool PackedCube::scramble_cube(const std::string& scramble) {
+    const std::array<uint8_t, SIZE> previous = state;
+    const char* text = scramble.data();
+    const char* end = text + scramble.size();
+    int move;
+
+    while ((move = Turns::parse_move(text, end)) != Turns::N_MOVES) {
+        if (move == Turns::INVALID_MOVE) {
+            state = previous;
+            return false;
+        }
+        turn(move);
+    }
+
+    return true;
+}
+
+// Moves all the stickers with the permutation of the sequence
+void PackedCube::apply(const PackedCube& sequence) {
+    permute(state.data(), sequence.state.data());
+}
+
+// Getter function for the sticker moved to a place by the sequence
+uint8_t PackedCube::source(int sticker) const {
+    return state[sticker];
+}
+
+// Getter function for the state array
+std::array<unsigned short, 54> PackedCube::get_state() const {
+    std::array<unsigned short, 54> stickers;
+
+    for (int i = 0; i < 54; i++) {
+        stickers[i] = state[i];
+    }
+
+    return stickers;
+}
+
+// Checking if the cube is solved
+bool PackedCube::is_solved() const {
+    return std::memcmp(state.data(), PackedCube().state.data(), SIZE) == 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include "parser.h"
+
+namespace min2phase { namespace parser {
+
+    //lower case header name or value
+    std::string lower(std::string text){
+        std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+        return text;
+    }
+
+    //parse the request at the start of the input, 0 if it is not complete yet
+    size_t parse(const std::string& input, size_t start, request_t& request){
+        size_t pos = start, eol, colon, length = 0;
+        std::string line, name, value, target, version;
+        bool first = true, close = false, keep = false;
+        char* end;
+
+        request = request_t();
+
+        while (true){
+            eol = input.find('\n', pos);
+
+            if (eol == std::string::npos || eol - start > MAX_HEAD){
+                if (input.length() - start <= MAX_HEAD)
+                    return 0;
+
+                request.status = 431;
+                return input.length() - start;
+            }
+
+            line.assign(input, pos, eol - pos);
+            pos = eol + 1;
+
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            if (first){
+                //empty lines before a request are ignored
+                if (!line.empty()){
+                    std::istringstream words(line);
+
+                    words >> request.method >> target >> version;
+                    first = false;
+                }
+            } else if (line.empty()){
+                break;
+            } else if ((colon = line.find(':')) == std::string::npos){
+                request.status = 400;
+            } else {
+                name = lower(line.substr(0, colon));
+                value = line.substr(line.find_first_not_of(" \t", colon + 1) == std::string::npos ?
+                                    line.length() : line.find_first_not_of(" \t", colon + 1));
+
+                if (name == "content-length"){
+                    length = std::strtoul(value.c_str(), &end, 10);
+                    if (value.empty() || *end != '\0')
+                        request.status = 400;
+                } else if (name == "connection"){
+                    value = lower(value);
+                    close |= value.find("close") != std::string::npos;
+                    keep |= value.find("keep-alive") != std::string::npos;
+                } else if (name == "transfer-encoding"){
+                    request.status = 411;
+                }
+            }
+        }
+
+        if (request.status == 0 && (target.empty() || target[0] != '/' ||
+            (version != "HTTP/1.0" && version != "HTTP/1.1")))
+            request.status = 400;
+
+        if (request.status == 0 && length > MAX_BODY)
+            request.status = 413;
+
+        if (request.status != 0)
+            return input.length() - start;
+
+        if (input.length() - pos < length)
+            return 0;
+
+        //the old clients send the query without the '?'
+        if (target.compare(0, 3, "/c=") == 0){
+            request.path = "/";
+            request.query = target.substr(1);
+        } else {
+            request.path = target.substr(0, target.find('?'));
+            request.query = target.length() > request.path.length() ? target.substr(request.path.length() + 1) : "";
+        }
+
+        request.body.assign(input, pos, length);
+        request.keepAlive = version == "HTTP/1.1" ? !close : keep;
+
+        return pos + length - start;
+    }
+
+    //read a parameter of the query, false if it is missing
+    bool param(const std::string& query, const char* name, std::string& value){
+        const size_t length = strlen(name);
+        size_t pos = 0, end;
+
+        while (pos < query.length()){
+            end = std::min(query.find('&', pos), query.length());
+
+            if (end - pos > length && query.compare(pos, length, name) == 0 && query[pos + length] == '='){
+                value.assign(query, pos + length + 1, end - pos - length - 1);
+                return true;
+            }
+
+            pos = end + 1;
+        }
+
+        return false;
+    }
+
+    //read the cubes of a batch: a JSON array of strings or one cube per line
+    bool readCubes(const std::string& body, std::vector<std::string>& cubes){
+        const size_t first = body.find_first_not_of(" \t\r\n"), before = cubes.size();
+        size_t pos, end;
+
+        if (first != std::string::npos && body[first] == '['){
+            pos = body.find_first_not_of(" \t\r\n", first + 1);
+
+            while (pos != std::string::npos && body[pos] == '"' && (end = body.find('"', pos + 1)) != std::string::npos){
+                cubes.push_back(body.substr(pos + 1, end - pos - 1));
+                pos = body.find_first_not_of(" \t\r\n", end + 1);
+
+                if (pos != std::string::npos && body[pos] == ',')
+                    pos = body.find_first_not_of(" \t\r\n", pos + 1);
+                else
+                    break;
+            }
+
+            //the array is closed and nothing follows it
+            return pos != std::string::npos && body[pos] == ']' &&
+                   body.find_first_not_of(" \t\r\n", pos + 1) == std::string::npos &&
+                   (cubes.size() == before || body[body.find_last_not_of(" \t\r\n", pos - 1)] == '"');
+        }
+
+        for (pos = 0; pos < body.length(); pos = end + 1){
+            end = std::min(body.find('\n', pos), body.length());
+
+            if (end > pos && body[end - 1] == '\r')
+                cubes.push_back(body.substr(pos, end - pos - 1));
+            else
+                cubes.push_back(body.substr(pos, end - pos));
+
+            //the empty lines have no cube
+            if (cubes.back().empty())
+                cubes.pop_back();
+        }
+
+        return true;
+    }
+
+}   }
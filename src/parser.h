@@ -0,0 +1,88 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the parser of the HTTP requests of the server. The
+ * requests are read from the input of a connection as it comes: a request
+ * is parsed when its head and its body are complete, the pipelined ones
+ * follow it in the same input.
+ */
+
+#ifndef MIN2PHASE_PARSER_H
+#define MIN2PHASE_PARSER_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace min2phase { namespace parser {
+
+    /**
+     * The longest request line with its headers and the longest body
+     * of a request.
+     */
+    const size_t MAX_HEAD = 8192;
+    const size_t MAX_BODY = 1 << 20;
+
+    /**
+     * A parsed request. The status is 0 for a valid request or the
+     * status of the error.
+     */
+    typedef struct request_s {
+        std::string method;
+        std::string path;
+        std::string query;
+        std::string body;
+        uint16_t status;
+        bool keepAlive;
+    }request_t;
+
+    /**
+     * Lower case of a header name or value.
+     *
+     * @param text      : the text.
+     * @return          : the text in lower case.
+     */
+    std::string lower(std::string text);
+
+    /**
+     * Parse the request at the start of the input. The old clients send
+     * the query without the '?': "/c=..." is the path "/" with the query
+     * "c=...". A request with an error has its status and takes all the
+     * input: 400 for a bad line, 411 for a chunked body, 413 for a body
+     * longer than MAX_BODY and 431 for a head longer than MAX_HEAD.
+     *
+     * @param input     : the bytes read.
+     * @param start     : where the request starts.
+     * @param request   : where to store the request.
+     * @return          : the bytes of the request, 0 if it is not complete
+     *                    yet.
+     */
+    size_t parse(const std::string& input, size_t start, request_t& request);
+
+    /**
+     * Read a parameter of a query.
+     *
+     * @param query     : the query, "name=value&..." without the '?'.
+     * @param name      : the name of the parameter.
+     * @param value     : where to store the value.
+     * @return          : false if the parameter is missing.
+     */
+    bool param(const std::string& query, const char* name, std::string& value);
+
+    /**
+     * Read the cubes of a batch: a JSON array of strings or one cube per
+     * line, the empty lines are skipped.
+     *
+     * @param body      : the body of the request.
+     * @param cubes     : where to append the cubes.
+     * @return          : false if the JSON array is malformed.
+     */
+    bool readCubes(const std::string& body, std::vector<std::string>& cubes);
+
+}   }
+
+#endif //MIN2PHASE_PARSER_H
@@ -0,0 +1,319 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <min2phase/tools.h>
+#include "info.h"
+#include "pools.h"
+
+namespace min2phase { namespace pools {
+
+    /**
+     * The parameters of the solves of the scrambles, the ones of
+     * generate_scrambles.
+     */
+    static const int8_t DEPTH = 28;
+    static const int32_t PROBE_MAX = 100000;
+
+    /**
+     * The size of a cache line, the two ends of a ring are on different lines.
+     */
+    static const uint8_t CACHE_LINE = 64;
+
+    /**
+     * A place of the ring. The sequence tells who can use it: a push when
+     * it is the position of the push, a pop when it is one more.
+     */
+    typedef struct slot_s {
+        std::atomic<uint64_t> sequence;
+        std::string scramble;
+    }slot_t;
+
+    /**
+     * The pool of a case: a bounded ring with many producers and consumers
+     * and the counters of its stats.
+     */
+    typedef struct pool_s {
+        char target;
+        char twist;
+        slot_t slots[CAPACITY];
+        char pad0[CACHE_LINE];
+        std::atomic<uint64_t> head;
+        char pad1[CACHE_LINE];
+        std::atomic<uint64_t> tail;
+        char pad2[CACHE_LINE];
+        std::atomic<bool> refilling;
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> refills;
+        std::atomic<int64_t> requested;
+        std::atomic<int64_t> lag;
+        std::atomic<int64_t> maxLag;
+    }pool_t;
+
+    /**
+     * The pools of the cases, by target and twist: 'C' is a buffer sticker
+     * so it is never a twist.
+     */
+    static std::atomic<pool_t*> pools[info::N_CORNER_STICKERS][info::N_CORNER_STICKERS];
+
+    /**
+     * The refill threads and the pools waiting for them.
+     */
+    static std::vector<std::thread> refillers;
+    static std::mutex refillLock;
+    static std::condition_variable refillReady;
+    static std::deque<pool_t*> refillQueue;
+    static bool isRunning = false;
+
+    //time for the refill lag
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    //scrambles ready in a pool
+    static uint32_t size(const pool_t& pool) {
+        const uint64_t head = pool.head.load(std::memory_order_acquire);
+        const uint64_t tail = pool.tail.load(std::memory_order_acquire);
+
+        return head > tail ? (uint32_t) (head - tail) : 0;
+    }
+
+    //add a scramble, false if the pool is full
+    static bool push(pool_t& pool, std::string&& scramble) {
+        uint64_t pos = pool.head.load(std::memory_order_relaxed), sequence;
+        slot_t* slot;
+
+        while (true) {
+            slot = &pool.slots[pos & (CAPACITY - 1)];
+            sequence = slot->sequence.load(std::memory_order_acquire);
+
+            if (sequence == pos) {
+                if (pool.head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (sequence < pos) {
+                return false;
+            } else {
+                pos = pool.head.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->scramble = std::move(scramble);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    //take a scramble, false if the pool is empty
+    static bool pop(pool_t& pool, std::string& scramble) {
+        uint64_t pos = pool.tail.load(std::memory_order_relaxed), sequence;
+        slot_t* slot;
+
+        while (true) {
+            slot = &pool.slots[pos & (CAPACITY - 1)];
+            sequence = slot->sequence.load(std::memory_order_acquire);
+
+            if (sequence == pos + 1) {
+                if (pool.tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (sequence < pos + 1) {
+                return false;
+            } else {
+                pos = pool.tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        scramble = std::move(slot->scramble);
+        slot->sequence.store(pos + CAPACITY, std::memory_order_release);
+
+        return true;
+    }
+
+    //queue a pool for the refill threads, once until it is full again
+    static void refill(pool_t& pool) {
+        if (pool.refilling.exchange(true))
+            return;
+
+        pool.requested = now();
+
+        {
+            std::lock_guard<std::mutex> lock(refillLock);
+            refillQueue.push_back(&pool);
+        }
+        refillReady.notify_one();
+    }
+
+    //refill thread: fills the pools up to the high watermark
+    static void refiller() {
+        Search search;
+        std::string scramble;
+        pool_t* pool;
+        int64_t lag;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(refillLock);
+
+                refillReady.wait(lock, [] { return !refillQueue.empty() || !isRunning; });
+
+                if (!isRunning)
+                    return;
+
+                pool = refillQueue.front();
+                refillQueue.pop_front();
+            }
+
+            while (size(*pool) < CAPACITY && !(scramble = generate(pool->target, pool->twist, search)).empty()) {
+                if (!push(*pool, std::move(scramble)))
+                    break;
+            }
+
+            lag = now() - pool->requested;
+            pool->lag = lag;
+            pool->maxLag = std::max(pool->maxLag.load(), lag);
+            pool->refills++;
+            pool->refilling = false;
+
+            //the requests took the scrambles during the refill
+            if (size(*pool) <= LOW_WATERMARK)
+                refill(*pool);
+        }
+    }
+
+    //get the pool of a case, the first request makes it
+    static pool_t& get(char target, char twist) {
+        std::atomic<pool_t*>& entry = pools[target - 'A'][twist - 'A'];
+        pool_t* pool = entry.load(std::memory_order_acquire), *expected = nullptr;
+        uint32_t i;
+
+        if (pool != nullptr)
+            return *pool;
+
+        pool = new pool_t();
+        pool->target = target;
+        pool->twist = twist;
+
+        for (i = 0; i < CAPACITY; i++)
+            pool->slots[i].sequence = i;
+
+        if (!entry.compare_exchange_strong(expected, pool, std::memory_order_acq_rel)) {
+            delete pool;
+            return *expected;
+        }
+
+        return *pool;
+    }
+
+    //draw and solve an LTCT case
+    std::string generate(char target, char twist, Search& search) {
+        std::string facelets, scramble;
+
+        do {
+            if ((facelets = tools::randomCube(target, twist)).empty())
+                return "";
+
+            scramble = search.solve(facelets, DEPTH, PROBE_MAX, 0, INVERSE_SOLUTION, nullptr);
+
+            //a search stopped by its budget has no scramble, drawing again would not stop
+            if (search.isExpired())
+                return "";
+        } while (tools::fromScramble(scramble) != facelets || !tools::isLtct(facelets, target, twist));
+
+        return scramble;
+    }
+
+    //pop a scramble, the pool is refilled at the low watermark
+    bool take(char target, char twist, std::string& scramble) {
+        pool_t& pool = get(target, twist);
+        const bool hit = pop(pool, scramble);
+
+        if (hit)
+            pool.hits++;
+        else
+            pool.misses++;
+
+        if (size(pool) <= LOW_WATERMARK)
+            refill(pool);
+
+        return hit;
+    }
+
+    //start the refill threads
+    void start(uint32_t nThreads) {
+        std::lock_guard<std::mutex> lock(refillLock);
+
+        isRunning = true;
+
+        for (uint32_t i = 0; i < nThreads; i++)
+            refillers.emplace_back(refiller);
+    }
+
+    //stop the refill threads, nothing takes from the pools
+    void stop() {
+        int8_t i, j;
+
+        {
+            std::lock_guard<std::mutex> lock(refillLock);
+            isRunning = false;
+        }
+        refillReady.notify_all();
+
+        for (std::thread& t : refillers)
+            t.join();
+
+        refillers.clear();
+        refillQueue.clear();
+
+        for (i = 0; i < info::N_CORNER_STICKERS; i++) {
+            for (j = 0; j < info::N_CORNER_STICKERS; j++)
+                delete pools[i][j].exchange(nullptr);
+        }
+    }
+
+    //the pools that were asked
+    std::vector<counters_t> counters() {
+        std::vector<counters_t> all;
+        int8_t i, j;
+        pool_t* pool;
+
+        for (i = 0; i < info::N_CORNER_STICKERS; i++) {
+            for (j = 0; j < info::N_CORNER_STICKERS; j++) {
+                if ((pool = pools[i][j].load(std::memory_order_acquire)) != nullptr)
+                    all.push_back({pool->target, pool->twist, size(*pool), pool->hits, pool->misses, pool->refills,
+                                   pool->lag, pool->maxLag});
+            }
+        }
+
+        return all;
+    }
+
+    //one line per pool
+    std::string stats() {
+        std::string text;
+        char line[256];
+
+        for (const counters_t& pool : counters()) {
+            std::snprintf(line, sizeof(line), "pool %c %c: %u of %u scrambles, %llu hits, %llu misses (%.2f%% hits), "
+                                              "%llu refills, refill lag %.2f ms (max %.2f ms)\n",
+                          pool.target, pool.twist, pool.size, CAPACITY, (unsigned long long) pool.hits,
+                          (unsigned long long) pool.misses, pool.hits + pool.misses == 0 ? 0.0 :
+                          100.0 * pool.hits / (pool.hits + pool.misses), (unsigned long long) pool.refills,
+                          pool.lag / 1000.0, pool.maxLag / 1000.0);
+            text += line;
+        }
+
+        return text;
+    }
+} }
@@ -0,0 +1,103 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the pools of the LTCT scrambles of the server. Every
+ * case (target, twist) that is asked has its pool: a lock-free ring of
+ * scrambles that are ready, so a request takes one with a pop. When a pop
+ * leaves the pool at the low watermark, the pool is refilled up to the high
+ * watermark by the refill threads in the background. A request that finds
+ * the pool empty makes its scramble with a solver thread.
+ */
+
+#ifndef MIN2PHASE_POOLS_H
+#define MIN2PHASE_POOLS_H 1
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Search.h"
+
+namespace min2phase { namespace pools {
+
+    /**
+     * The scrambles of a pool, a power of two: the high watermark.
+     */
+    const uint32_t CAPACITY = 64;
+
+    /**
+     * The scrambles left in a pool when it is refilled.
+     */
+    const uint32_t LOW_WATERMARK = 16;
+
+    /**
+     * The counters of a pool, the lags are in microseconds.
+     */
+    typedef struct counters_s {
+        char target;
+        char twist;
+        uint32_t size;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t refills;
+        int64_t lag;
+        int64_t maxLag;
+    }counters_t;
+
+    /**
+     * Draw an LTCT case until its scramble makes the cube and the cube is
+     * the case.
+     *
+     * @param target    : the last corner target (Speffz).
+     * @param twist     : the twisted corner (Speffz), 'C' for none.
+     * @param search    : the search used for the solves.
+     * @return          : the scramble, empty if the tables are not loaded
+     *                    or the budget of the search stopped it.
+     */
+    std::string generate(char target, char twist, Search& search);
+
+    /**
+     * Take a scramble from the pool of a case, the pool is made with the
+     * first request of the case. The case must be valid, see
+     * tools::validLtct. It is thread safe and does not wait.
+     *
+     * @param target    : the last corner target (Speffz).
+     * @param twist     : the twisted corner (Speffz), 'C' for none.
+     * @param scramble  : where to store the scramble.
+     * @return          : false if the pool is empty, the caller makes the
+     *                    scramble with generate.
+     */
+    bool take(char target, char twist, std::string& scramble);
+
+    /**
+     * Start the refill threads.
+     *
+     * @param nThreads  : the number of refill threads.
+     */
+    void start(uint32_t nThreads);
+
+    /**
+     * Stop the refill threads and remove the pools.
+     */
+    void stop();
+
+    /**
+     * Get the counters of every pool.
+     *
+     * @return          : the counters, one for each pool.
+     */
+    std::vector<counters_t> counters();
+
+    /**
+     * Get the state of every pool: the scrambles ready, the hits and the
+     * misses of the requests and the time the last refill took from the
+     * low watermark to the high one, one line per pool.
+     *
+     * @return          : the stats, empty if there are no pools.
+     */
+    std::string stats();
+} }
+
+#endif //MIN2PHASE_POOLS_H
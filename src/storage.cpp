@@ -0,0 +1,273 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ */
+
+#include <min2phase/min2phase.h>
+#include "coords.h"
+#include "storage.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace min2phase { namespace storage {
+
+    /**
+     * The first bytes of the file.
+     */
+    static const char MAGIC[] = {'M', '2', 'P', 'C'};
+
+    /**
+     * The start value of the FNV-1a checksum.
+     */
+    static const uint32_t FNV_OFFSET = 0x811c9dc5;
+
+    /**
+     * The prime of the FNV-1a checksum.
+     */
+    static const uint32_t FNV_PRIME = 0x01000193;
+
+    /**
+     * A table stored in the file.
+     */
+    typedef struct table_s {
+        /**
+         * The first value of the table.
+         */
+        uint8_t* data;
+
+        /**
+         * The number of values.
+         */
+        uint32_t count;
+
+        /**
+         * The size in bytes of every value.
+         */
+        uint8_t width;
+    }table_t;
+
+    //one dimension table
+    template<typename T, size_t N>
+    static table_t table(T (&arr)[N]) {
+        static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "no fixed size");
+        return {reinterpret_cast<uint8_t*>(arr), (uint32_t) N, (uint8_t) sizeof(T)};
+    }
+
+    //two dimensions table
+    template<typename T, size_t N, size_t M>
+    static table_t table(T (&arr)[N][M]) {
+        static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "no fixed size");
+        return {reinterpret_cast<uint8_t*>(arr), (uint32_t) (N * M), (uint8_t) sizeof(T)};
+    }
+
+    /**
+     * Get the list of the tables in the order used in the file.
+     *
+     * @param profile   : the set of tables.
+     * @return          : the tables.
+     */
+    static std::vector<table_t> tables(Profile profile) {
+        coords::coords_t& c = coords::coords;
+        std::vector<table_t> list;
+        uint8_t i;
+
+        for (i = 0; i < info::N_MOVES; i++) {
+            list.push_back(table(c.moveCube[i].edges));
+            list.push_back(table(c.moveCube[i].corners));
+        }
+
+        for (i = 0; i < info::SYM; i++) {
+            list.push_back(table(c.CubeSym[i].edges));
+            list.push_back(table(c.CubeSym[i].corners));
+        }
+
+        list.push_back(table(c.firstMoveSym));
+        list.push_back(table(c.SymMove));
+        list.push_back(table(c.Sym8Move));
+        list.push_back(table(c.PermInvEdgeSym));
+        list.push_back(table(c.moveCubeSym));
+        list.push_back(table(c.SymMult));
+        list.push_back(table(c.SymMultInv));
+        list.push_back(table(c.SymMoveUD));
+        list.push_back(table(c.MPermInv));
+        list.push_back(table(c.Perm2CombP));
+        list.push_back(table(c.FlipS2RF));
+        list.push_back(table(c.EPermR2S));
+        list.push_back(table(c.FlipR2S));
+        list.push_back(table(c.TwistR2S));
+        list.push_back(table(c.FlipMove));
+        list.push_back(table(c.TwistMove));
+        list.push_back(table(c.UDSliceMove));
+        list.push_back(table(c.UDSliceConj));
+        list.push_back(table(c.UDSliceTwistPrun));
+        list.push_back(table(c.UDSliceFlipPrun));
+        if (profile != MINIMAL_TABLES)
+            list.push_back(table(c.TwistFlipPrun));
+
+        list.push_back(table(c.CPermMove));
+        list.push_back(table(c.EPermMove));
+        list.push_back(table(c.MPermMove));
+        list.push_back(table(c.MPermConj));
+        list.push_back(table(c.CCombPConj));
+        list.push_back(table(c.MCPermPrun));
+        list.push_back(table(c.EPermCCombPPrun));
+        list.push_back(table(c.CCombPMove));
+        list.push_back(table(c.urf.edges));
+        list.push_back(table(c.urf.corners));
+        list.push_back(table(c.urfInv.edges));
+        list.push_back(table(c.urfInv.corners));
+
+        if (profile == LARGE_TABLES) {
+            list.push_back(table(c.CPermFullMove));
+            list.push_back(table(c.TwistRawMove));
+            list.push_back(table(c.TwistConj));
+            list.push_back(table(c.CPermTwistPrun));
+        }
+
+        return list;
+    }
+
+    /**
+     * Check the byte order of the machine.
+     *
+     * @return      : true if the machine is little endian, false if not.
+     */
+    static bool isLittleEndian() {
+        const uint16_t one = 1;
+
+        return *reinterpret_cast<const uint8_t*>(&one) == 1;
+    }
+
+    /**
+     * Convert the values of a table from little endian to the machine order,
+     * or the opposite. It does nothing on little endian machines.
+     *
+     * @param data  : the values to convert.
+     * @param count : the number of values.
+     * @param width : the size in bytes of every value.
+     */
+    static void swap(uint8_t* data, uint32_t count, uint8_t width) {
+        uint32_t i;
+
+        if (width == 1 || isLittleEndian())
+            return;
+
+        for (i = 0; i < count; i++, data += width)
+            std::reverse(data, data + width);
+    }
+
+    //FNV-1a
+    static uint32_t checksum(uint32_t hash, const uint8_t* data, uint32_t size) {
+        uint32_t i;
+
+        for (i = 0; i < size; i++)
+            hash = (hash ^ data[i]) * FNV_PRIME;
+
+        return hash;
+    }
+
+    //write a little endian value
+    static void putU16(uint8_t* out, uint16_t val) {
+        out[0] = val & 0xff;
+        out[1] = val >> 8;
+    }
+
+    //read a little endian value
+    static uint16_t getU16(const uint8_t* in) {
+        return uint16_t(in[0] | in[1] << 8);
+    }
+
+    //write a little endian value
+    static void putU32(uint8_t* out, uint32_t val) {
+        for (uint8_t i = 0; i < 4; i++)
+            out[i] = val >> (i << 3) & 0xff;
+    }
+
+    //read a little endian value
+    static uint32_t getU32(const uint8_t* in) {
+        uint32_t val = 0;
+
+        for (uint8_t i = 0; i < 4; i++)
+            val |= uint32_t(in[i]) << (i << 3);
+
+        return val;
+    }
+
+    //write the tables
+    bool write(const std::string& name, Profile profile, uint32_t* checksum) {
+        std::ofstream out(name, std::ios::binary);
+        uint8_t header[HEADER_SIZE];
+        std::vector<uint8_t> buffer;
+        uint32_t size = 0, hash = FNV_OFFSET, bytes;
+
+        if (!out)
+            return false;
+
+        out.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+
+        for (const table_t& t : tables(profile)) {
+            bytes = t.count * t.width;
+            buffer.assign(t.data, t.data + bytes);
+            swap(buffer.data(), t.count, t.width);
+            hash = storage::checksum(hash, buffer.data(), bytes);
+            out.write(reinterpret_cast<const char*>(buffer.data()), bytes);
+            size += bytes;
+        }
+
+        std::copy(MAGIC, MAGIC + 4, header);
+        putU16(header + 4, VERSION);
+        putU16(header + 6, profile);
+        putU32(header + 8, size);
+        putU32(header + 12, hash);
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+
+        if (checksum != nullptr)
+            *checksum = hash;
+
+        return out.good();
+    }
+
+    //read the tables
+    bool read(const std::string& name, Profile profile) {
+        std::ifstream in(name, std::ios::binary);
+        std::vector<table_t> list = tables(profile);
+        uint8_t header[HEADER_SIZE];
+        std::vector<uint8_t> buffer;
+        const uint8_t* data;
+        uint32_t size = 0, bytes;
+
+        if (!in || !in.read(reinterpret_cast<char*>(header), HEADER_SIZE))
+            return false;
+
+        for (const table_t& t : list)
+            size += t.count * t.width;
+
+        if (!std::equal(MAGIC, MAGIC + 4, header) || getU16(header + 4) != VERSION
+            || getU16(header + 6) != profile || getU32(header + 8) != size)
+            return false;
+
+        //the tables in memory are written only when the whole file is correct
+        buffer.resize(size);
+
+        if (!in.read(reinterpret_cast<char*>(buffer.data()), size) ||
+            checksum(FNV_OFFSET, buffer.data(), size) != getU32(header + 12))
+            return false;
+
+        data = buffer.data();
+
+        for (const table_t& t : list) {
+            bytes = t.count * t.width;
+            std::copy(data, data + bytes, t.data);
+            swap(t.data, t.count, t.width);
+            data += bytes;
+        }
+
+        return true;
+    }
+} }
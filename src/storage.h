@@ -0,0 +1,66 @@
+/**
+ * min2phaseCXX Copyright (C) 2022 Borgo Federico
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+ *
+ * This file contains the reader and the writer of the tables file.
+ * The file does not depend on the machine that wrote it: every table is
+ * stored in a fixed order, every value is little endian with an explicit
+ * size and there is no padding. So a file generated on x86 can be loaded
+ * on ARM. The tables are checked before they are copied in memory, a file
+ * that is not valid leaves them as they were.
+ *
+ * Layout:
+ * | offset | size |                     content                      |
+ * |:------:|:----:|:------------------------------------------------:|
+ * |    0   |   4  | magic "M2PC"                                     |
+ * |    4   |   2  | version                                          |
+ * |    6   |   2  | profile, the set of tables stored                |
+ * |    8   |   4  | size of the tables in bytes                      |
+ * |   12   |   4  | FNV-1a checksum of the tables                    |
+ * |   16   |   -  | the tables of the profile, in the order of coords_t |
+ */
+
+#ifndef MIN2PHASE_STORAGE_H
+#define MIN2PHASE_STORAGE_H 1
+
+#include <min2phase/min2phase.h>
+#include <cstdint>
+#include <string>
+
+namespace min2phase { namespace storage {
+
+    /**
+     * The version of the file, change it when the tables change.
+     */
+    const uint16_t VERSION = 2;
+
+    /**
+     * The size of the file header.
+     */
+    const uint8_t HEADER_SIZE = 16;
+
+    /**
+     * Write the tables in the portable format.
+     *
+     * @param name      : the name and path of the file.
+     * @param profile   : the set of tables to write.
+     * @param checksum  : (Optional) where to store the checksum of the tables.
+     * @return          : true if the file was written, false if not.
+     */
+    bool write(const std::string& name, Profile profile, uint32_t* checksum = nullptr);
+
+    /**
+     * Read the tables from a file in the portable format. The file is rejected
+     * if the magic, the version, the profile, the size or the checksum are not correct,
+     * then the tables are not changed.
+     *
+     * @param name      : the name and path of the file.
+     * @param profile   : the set of tables expected.
+     * @return          : true if the tables were read, false if not.
+     */
+    bool read(const std::string& name, Profile profile);
+} }
+
+#endif //MIN2PHASE_STORAGE_H
@@ -5,17 +5,116 @@
  * under certain conditions; type `show c' for details.
  */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include <min2phase/tools.h>
 #include <iostream>
 #include <min2phase/min2phase.h>
+#include "binary.h"
+#include "cache.h"
+#include "constraints.h"
+#include "http.h"
 #include "info.h"
+#include "metrics.h"
+#include "parser.h"
+#include "pools.h"
 #include "tests.h"
 #include "Search.h"
+#include "storage.h"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 namespace min2phase{ namespace tests{
     const uint8_t N_CUBE_TESTS = 255;
 
+    /**
+     * The file used to test the tables file.
+     */
+    const char TABLES_FILE[] = "tests.m2pc";
+
+    /**
+     * The checksum of the tables. The file is the same on every machine,
+     * so this must not change when the tests run on ARM or big endian.
+     */
+    const uint32_t TABLES_CHECKSUM = 0x934aa066;
+
+    /**
+     * The hash of the solved cube, it must be the same on every machine.
+     */
+    const uint64_t SOLVED_HASH = 0x6393d51c06c618dc;
+
+    /**
+     * The number of cubes solved through the cache.
+     */
+    const uint8_t N_CACHE_TESTS = 16;
+
+    /**
+     * The time of the search stopped by its deadline, in milliseconds.
+     */
+    const uint16_t BUDGET_MS = 20;
+
+    /**
+     * The threads that solve the same cube at the same time.
+     */
+    const uint8_t N_CACHE_THREADS = 8;
+
+    /**
+     * The budget of a search that others wait for, and the time it has to
+     * start before them, in milliseconds.
+     */
+    const uint16_t LEADER_MS = 1000;
+    const uint16_t LEADER_START_MS = 100;
+
+    /**
+     * The probes of phase 2 of the search that the threads share: it is
+     * long enough that they come while it is running.
+     */
+    const int32_t SHARED_PROBES = 10000;
+
+    /**
+     * The port of the server of the tests and the jobs its queue takes
+     * per solver thread, see http::init.
+     */
+    const uint16_t SERVER_PORT = 28131;
+    const size_t QUEUE_PER_THREAD = 64;
+
+    /**
+     * The cubes sent through the codec of the binary protocol.
+     */
+    const uint8_t N_BINARY_TESTS = 16;
+
+    /**
+     * The number of cubes solved with every set of tables.
+     */
+    const uint8_t N_PROFILE_TESTS = 5;
+
+    /**
+     * The scrambles solved optimally with every set of tables.
+     */
+    const char* const PROFILE_SCRAMBLES[N_PROFILE_TESTS] = {
+            "R U2 F' L D2 B R' U F2 D",
+            "F2 L' U B2 R D' F U2 L2 B'",
+            "D R2 B' U' L F2 D2 R' B U2",
+            "L2 F D' R U' B2 L' D F' R2",
+            "B U' R2 D L' F2 U R' B2 L"
+    };
+
     //verify error input
     void testInput(){
         //YYWOYYGBO GGOOBRWBG RRYOOWWRR OWBOWWBYR RGYWGYYBB GRBGRGWBO
@@ -36,6 +135,8 @@ namespace min2phase{ namespace tests{
 
     //test search errors
     void testSearchError(){
+        const std::atomic<bool> cancel(true);
+        std::string cube;
         Search s;
 
         //YYWOYYGBO GGOOBRWBG RRYOOWWRR OWBOWWBYR RGYWGYYBB GRBGRGWBO
@@ -45,6 +146,23 @@ namespace min2phase{ namespace tests{
         //YYWOYYGBO GGOOBRWBG RRYOOWWRR OWBOWWBYR RGYWGYYBB GRBGRGWBO
         assert(s.solve("YYWOYYGBOGGOOBRWBGRRYOOWWRROWBOWWBYRRGYWGYYBBGRBGRGWBO", 1, 100000, 0, 0, nullptr) == std::to_string(info::SHORT_DEPTH));
 
+        //a deadline that passed, then a cancelled search
+        s = Search();
+        s.setBudget(std::chrono::steady_clock::now(), nullptr);
+        assert(s.solve("YYWOYYGBOGGOOBRWBGRRYOOWWRROWBOWWBYRRGYWGYYBBGRBGRGWBO", 31, 100000, 0, 0, nullptr) == std::to_string(info::TIME_LIMIT));
+        assert(s.isExpired());
+
+        s.setBudget(std::chrono::steady_clock::time_point::max(), &cancel);
+        assert(s.solve("YYWOYYGBOGGOOBRWBGRRYOOWWRROWBOWWBYRRGYWGYYBBGRBGRGWBO", 31, 100000, 0, 0, nullptr) == std::to_string(info::TIME_LIMIT));
+
+        //the deadline stops the search of a shorter solution with the best one found
+        cube = tools::randomCube();
+        s.setBudget(std::chrono::steady_clock::now() + std::chrono::milliseconds(BUDGET_MS), nullptr);
+        assert(tools::fromScramble(s.solve(cube, 21, 100000, INT32_MAX, INVERSE_SOLUTION, nullptr)) == cube && s.isExpired());
+
+        s.setBudget(std::chrono::steady_clock::time_point::max(), nullptr);
+        assert(s.solve(cube, 21, 100000, 0, 0, nullptr) == Search().solve(cube, 21, 100000, 0, 0, nullptr) && !s.isExpired());
+
         coords::coords.isInitialized = false;
 
         s = Search();
@@ -65,6 +183,516 @@ namespace min2phase{ namespace tests{
 
             assert(tools::fromScramble(s.solve(cube, 31, 100000, 0, min2phase::INVERSE_SOLUTION, nullptr)) == cube);
         }
+
+        //a search used again finds the same solutions as a new one
+        for(uint8_t i = 0; i < N_CUBE_TESTS; i++){
+            cube = tools::randomCube();
+
+            assert(s.solve(cube, 31, 100000, 0, 0, nullptr) == Search().solve(cube, 31, 100000, 0, 0, nullptr));
+        }
+    }
+
+    //test the tables file
+    void testTableFile(){
+        std::vector<uint8_t> tables(sizeof(coords::coords_t));
+        std::string cube = tools::randomCube();
+        std::string sol = Search().solve(cube, 21, 100000, 0, 0, nullptr);
+        uint32_t checksum;
+
+        std::memcpy(tables.data(), &coords::coords, tables.size());
+
+        assert(storage::write(TABLES_FILE, STANDARD_TABLES, &checksum));
+        assert(checksum == TABLES_CHECKSUM);
+
+        std::memset(coords::coords.TwistFlipPrun, 0, sizeof(coords::coords.TwistFlipPrun));
+        std::memset(coords::coords.CPermMove, 0, sizeof(coords::coords.CPermMove));
+        std::memset(coords::coords.moveCubeSym, 0, sizeof(coords::coords.moveCubeSym));
+
+        assert(storage::read(TABLES_FILE, STANDARD_TABLES));
+        assert(std::memcmp(tables.data(), &coords::coords, tables.size()) == 0);
+        assert(Search().solve(cube, 21, 100000, 0, 0, nullptr) == sol);
+
+        //corrupted file
+        std::fstream file(TABLES_FILE, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(storage::HEADER_SIZE + 1000);
+        file.put(0x55);
+        file.close();
+
+        assert(!storage::read(TABLES_FILE, STANDARD_TABLES));
+        assert(std::memcmp(tables.data(), &coords::coords, tables.size()) == 0);
+        assert(loadFile(TABLES_FILE) == false);
+        coords::wait();
+        assert(std::memcmp(tables.data(), &coords::coords, tables.size()) == 0);
+
+        std::remove(TABLES_FILE);
+    }
+
+    //test the solver with the weak phase 1 bounds
+    void testProgressive(){
+        std::string cube;
+
+        coords::initAsync(STANDARD_TABLES);
+
+        for(uint8_t i = 0; i < N_CUBE_TESTS && !coords::isComplete(); i++){
+            cube = tools::randomCube();
+            assert(tools::fromScramble(Search().solve(cube, 31, 100000, 0, min2phase::INVERSE_SOLUTION, nullptr)) == cube);
+        }
+
+        coords::wait();
+        assert(coords::isComplete());
+    }
+
+    //test the sets of tables
+    void testProfiles(){
+        const Profile profiles[] = {MINIMAL_TABLES, LARGE_TABLES};
+        std::string cubes[N_PROFILE_TESTS], solutions[N_PROFILE_TESTS], cube;
+        int8_t length;
+        uint8_t i;
+
+        for(i = 0; i < N_PROFILE_TESTS; i++){
+            cubes[i] = tools::fromScramble(PROFILE_SCRAMBLES[i]);
+            solutions[i] = Search().solve(cubes[i], 31, 100000, 0, OPTIMAL_SOLUTION, nullptr);
+        }
+
+        for(Profile profile : profiles){
+            coords::init(profile);
+            assert(coords::getProfile() == profile);
+            assert(coords::useCornerPrun() == (profile == LARGE_TABLES));
+
+            for(i = 0; i < N_PROFILE_TESTS; i++){
+                cube = tools::randomCube();
+                assert(tools::fromScramble(Search().solve(cube, 31, 100000, 0, INVERSE_SOLUTION, nullptr)) == cube);
+                assert(Search().solve(cubes[i], 31, 100000, 0, OPTIMAL_SOLUTION, nullptr).size() == solutions[i].size());
+                length = (int8_t) std::count_if(solutions[i].begin(), solutions[i].end(), ::isupper);
+                assert(Search().solve(cubes[i], int8_t(length - 1), 100000, 0, 0, nullptr) == std::to_string(info::SHORT_DEPTH));
+            }
+        }
+
+        coords::init(STANDARD_TABLES);
+    }
+
+    //test the coordinates kernels
+    void testCoordinates(){
+        CubieCube cube;
+        int32_t perm, i, j;
+        int8_t inversions;
+        uint16_t n;
+
+        for(perm = 0; perm < info::N_PERM; perm++){
+            cube.setCPerm((uint16_t) perm);
+            assert(cube.getCPerm() == perm);
+
+            for(inversions = 0, i = 0; i < info::NUMBER_CORNER; i++)
+                for(j = i + 1; j < info::NUMBER_CORNER; j++)
+                    inversions += (cube.corners[i] & 7) > (cube.corners[j] & 7);
+
+            assert(CubieCube::getNParity((uint32_t) perm, info::NUMBER_CORNER) == (inversions & 1));
+        }
+
+        for(n = 0; n < info::N_SLICE; n++){
+            cube.setUDSlice((int16_t) n);
+            assert(cube.getUDSlice() == n);
+        }
+
+        for(n = 0; n < N_CUBE_TESTS; n++){
+            perm = std::rand() % 479001600;
+            cube.setCoords(0, 0, perm, 0);
+            assert(cube.getMPerm() == perm % info::N_MPERM);
+
+            for(inversions = 0, i = 0; i < info::NUMBER_EDGES; i++)
+                for(j = i + 1; j < info::NUMBER_EDGES; j++)
+                    inversions += (cube.edges[i] >> 1) > (cube.edges[j] >> 1);
+
+            assert(CubieCube::getNParity((uint32_t) perm, info::NUMBER_EDGES) == (inversions & 1));
+        }
+    }
+
+    //verify the keys and the hashes of the states
+    void testStateKey(){
+        std::vector<std::string> cubes;
+        std::vector<std::array<uint64_t, 2>> keys;
+        std::string recolored;
+        uint64_t key[2], other[2];
+        uint8_t i;
+
+        assert(tools::stateKey(tools::fromScramble(""), key));
+        assert(tools::stateHash(key) == SOLVED_HASH);
+        assert(!tools::stateKey("YYWOYYGBOGGOOBRWBGRRYOOWWRROWBOWWBYRRGYWGYYBBGRBGRGWB", key));
+
+        for(i = 0; i < N_CUBE_TESTS; i++){
+            cubes.push_back(tools::randomCube());
+            assert(tools::stateKey(cubes.back(), key));
+            keys.push_back({{key[0], key[1]}});
+
+            //the colors do not change the state
+            recolored = cubes.back();
+            std::replace(recolored.begin(), recolored.end(), 'U', 'W');
+            std::replace(recolored.begin(), recolored.end(), 'F', 'G');
+            assert(tools::stateKey(recolored, other));
+            assert(other[0] == key[0] && other[1] == key[1]);
+        }
+
+        std::sort(keys.begin(), keys.end());
+        assert(std::unique(keys.begin(), keys.end()) == keys.end());
+    }
+
+    //verify the constraints on the trace
+    void testConstraints(){
+        CubieCube cube;
+        uint8_t i;
+
+        assert(!tools::addConstraint("flips"));
+        assert(!tools::addConstraint("flips=12"));
+        assert(!tools::addConstraint("flips=3-1"));
+        assert(!tools::addConstraint("edge-targets=1-x"));
+        assert(!tools::addConstraint("parity-target=C"));
+        assert(!tools::addConstraint("spins=1"));
+
+        //R U: corners ADKWQE, edges JVTBAD
+        assert(CubieCube::fromFacelets(tools::fromScramble("R U"), cube) == info::NO_ERROR);
+        assert(tools::addConstraint("corner-targets=6") && tools::addConstraint("corner-cycles=1"));
+        assert(tools::addConstraint("twists=0") && tools::addConstraint("edge-targets=5-7"));
+        assert(tools::addConstraint("edge-cycles=1") && tools::addConstraint("parity-target=D"));
+        assert(constraints::acceptCorners(cube, cube.getCPerm()) && constraints::acceptEdges(cube));
+        tools::clearConstraints();
+
+        assert(tools::addConstraint("parity-target=A"));
+        assert(!constraints::acceptEdges(cube));
+        tools::clearConstraints();
+
+        assert(CubieCube::fromFacelets(tools::superFlip(), cube) == info::NO_ERROR);
+        assert(tools::addConstraint("flips=11") && tools::addConstraint("edge-targets=0"));
+        assert(constraints::acceptEdges(cube));
+        tools::clearConstraints();
+
+        assert(tools::addConstraint("corner-cycles=2-3") && tools::addConstraint("flips=0-1"));
+        for(i = 0; i < N_CUBE_TESTS; i++){
+            assert(CubieCube::fromFacelets(tools::randomCube(), cube) == info::NO_ERROR);
+            assert(constraints::acceptCorners(cube, cube.getCPerm()) && constraints::acceptEdges(cube));
+        }
+
+        assert(!tools::constraintsReport().empty());
+        tools::clearConstraints();
+        assert(tools::constraintsReport().empty());
+    }
+
+    //test the cache of the solutions
+    void testCache(){
+        Search search;
+        std::string cube, recolored, solution;
+        std::string results[N_CACHE_THREADS];
+        std::vector<std::thread> threads;
+        uint8_t moves = 0, cached = 0;
+        uint64_t coalesced;
+
+        cache::clear();
+
+        for(uint8_t i = 0; i < N_CACHE_TESTS; i++){
+            cube = tools::randomCube();
+            solution = cache::solve(search, cube, 21, 100000, 0, 0, &moves);
+            assert(solution == Search().solve(cube, 21, 100000, 0, 0, nullptr));
+
+            //the same state with other colors, then other parameters
+            recolored = cube;
+            std::replace(recolored.begin(), recolored.end(), 'U', 'W');
+            assert(cache::solve(search, recolored, 21, 100000, 0, 0, &cached) == solution && cached == moves);
+            assert(cache::solve(search, cube, 21, 100000, 0, INVERSE_SOLUTION, nullptr) != solution);
+        }
+
+        assert(cache::stats().find(std::to_string(N_CACHE_TESTS) + " hits") != std::string::npos);
+
+        cache::setLimit(0);
+        assert(cache::stats().find("cache: 0 solutions") == 0);
+
+        //the same cube at the same time, without the cache: the first search is shared by the others
+        cube = tools::randomCube();
+        solution = Search().solve(cube, 21, 100000, SHARED_PROBES, 0, nullptr);
+        coalesced = cache::counters().coalesced;
+
+        for(std::string& result : results){
+            threads.emplace_back([&cube, &result] { Search s; result = cache::solve(s, cube, 21, 100000, SHARED_PROBES, 0, nullptr); });
+
+            if(threads.size() == 1)
+                std::this_thread::sleep_for(std::chrono::milliseconds(LEADER_START_MS));
+        }
+
+        for(std::thread& t : threads)
+            t.join();
+
+        for(const std::string& result : results)
+            assert(result == solution);
+
+        assert(cache::counters().coalesced > coalesced);
+
+        //the requests that wait for a long search stop at their own deadline and flag
+        std::thread leader([&cube] {
+            Search s;
+            s.setBudget(std::chrono::steady_clock::now() + std::chrono::milliseconds(LEADER_MS), nullptr);
+            cache::solve(s, cube, 21, 100000, 1000000000, 0, nullptr);
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(LEADER_START_MS));
+        const auto start = std::chrono::steady_clock::now();
+        const std::atomic<bool> cancel(true);
+
+        search.setBudget(start + std::chrono::milliseconds(BUDGET_MS), nullptr);
+        assert(cache::solve(search, cube, 21, 100000, 1000000000, 0, nullptr) == std::to_string(info::TIME_LIMIT));
+        search.setBudget(std::chrono::steady_clock::time_point::max(), &cancel);
+        assert(cache::solve(search, cube, 21, 100000, 1000000000, 0, nullptr) == std::to_string(info::TIME_LIMIT));
+        assert(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(LEADER_MS / 2));
+
+        leader.join();
+        search.setBudget(std::chrono::steady_clock::time_point::max(), nullptr);
+
+        cache::setLimit(cache::DEFAULT_LIMIT);
+        cache::clear();
+    }
+
+    //test the LTCT cases
+    void testLtct(){
+        const std::atomic<bool> cancel(true);
+        std::string cube;
+        Search search;
+
+        assert(!tools::validLtct('C') && !tools::validLtct('Y') && !tools::validLtct('D', 'Z'));
+        assert(tools::validLtct('D') && tools::validLtct('D', 'E') && !tools::validLtct('D', 'I'));
+        assert(!tools::isLtct(tools::fromScramble(""), 'D'));
+
+        for(uint8_t i = 0; i < N_CUBE_TESTS; i++){
+            cube = tools::randomCube('D', 'E');
+            assert(tools::isLtct(cube, 'D', 'E') && !tools::isLtct(cube, 'D'));
+        }
+
+        //a cancelled search gives no scramble instead of drawing forever
+        search.setBudget(std::chrono::steady_clock::time_point::max(), &cancel);
+        assert(pools::generate('D', 'C', search).empty());
+    }
+
+    //test the metrics
+    void testMetrics(){
+        const std::string count = "min2phase_solve_seconds_count ", inf = "min2phase_solve_seconds_bucket{le=\"+Inf\"} ";
+        Search search;
+        std::string text;
+
+        //the counts of two threads are summed, a gauge is moved by both
+        metrics::request(metrics::PING);
+        metrics::gauge(metrics::QUEUE_DEPTH, 3);
+        std::thread([] { metrics::request(metrics::PING); metrics::gauge(metrics::QUEUE_DEPTH, -1); }).join();
+
+        text = metrics::text();
+        assert(text.find("min2phase_requests_total{endpoint=\"ping\"} 2\n") != std::string::npos);
+        assert(text.find("\nmin2phase_queue_depth 2\n") != std::string::npos);
+        metrics::gauge(metrics::QUEUE_DEPTH, -2);
+
+        //every solve of the cache is in the last bucket
+        cache::solve(search, tools::randomCube(), 21, 100000, 0, 0, nullptr);
+        text = metrics::text();
+
+        assert(text.find(count) != std::string::npos && text.find(inf) != std::string::npos);
+        assert(std::stoull(text.substr(text.find(count) + count.length())) > 0);
+        assert(std::stoull(text.substr(text.find(count) + count.length())) ==
+               std::stoull(text.substr(text.find(inf) + inf.length())));
+        assert(text.find("min2phase_cache_requests_total{result=\"miss\"} " +
+                         std::to_string(cache::counters().misses) + "\n") != std::string::npos);
+    }
+
+    //test the binary protocol
+    void testBinary(){
+        const char* names[] = {"U", "U2", "U'", "R", "R2", "R'", "F", "F2", "F'",
+                               "D", "D2", "D'", "L", "L2", "L'", "B", "B2", "B'"};
+        const uint64_t outOfRange[2] = {40320, 0};
+        binary::request_t request = {7, 21, INVERSE_SOLUTION, 100000, 0, 250, {0, 0}}, read;
+        RemoteSolution solution, back;
+        std::string cube, facelets, frame, scramble;
+        uint64_t key[2];
+        uint32_t id;
+        Search search;
+
+        for(uint8_t i = 0; i < N_BINARY_TESTS; i++){
+            cube = tools::randomCube();
+
+            //the key gives back the same state
+            assert(tools::stateKey(cube, request.key) && binary::toFacelets(request.key, facelets));
+            assert(tools::stateKey(facelets, key) && key[0] == request.key[0] && key[1] == request.key[1]);
+
+            //the moves are the scramble of the cube
+            binary::toMoves(search.solve(cube, 21, 100000, 0, INVERSE_SOLUTION, nullptr), solution);
+            assert(solution.error == info::NO_ERROR && solution.length > 0);
+
+            for(scramble.clear(), id = 0; id < solution.length; id++)
+                scramble += std::string(names[solution.moves[id]]) + " ";
+
+            assert(tools::stateKey(tools::fromScramble(scramble), key) &&
+                   key[0] == request.key[0] && key[1] == request.key[1]);
+        }
+
+        //the frames are read back as they were written, not before they are complete
+        frame.clear();
+        binary::writeRequest(request, frame);
+        assert(frame.length() == binary::REQUEST_SIZE);
+        assert(binary::readRequest(frame.substr(0, binary::REQUEST_SIZE - 1), 0, read) == 0);
+        assert(binary::readRequest(frame, 0, read) == binary::REQUEST_SIZE);
+        assert(read.id == 7 && read.maxDepth == 21 && read.verbose == INVERSE_SOLUTION && read.probeMax == 100000 &&
+               read.probeMin == 0 && read.timeout == 250 && read.key[0] == request.key[0] && read.key[1] == request.key[1]);
+
+        frame.clear();
+        binary::writeResponse(9, solution, frame);
+        assert(binary::readResponse(frame.substr(0, frame.length() - 1), 0, id, back) == 0);
+        assert(binary::readResponse(frame, 0, id, back) == frame.length() && id == 9 && back.length == solution.length);
+        assert(std::memcmp(back.moves, solution.moves, solution.length) == 0);
+
+        //a response whose length is too long or does not match its moves can not be read
+        frame[0] = (char) (binary::RESPONSE_HEAD - 4 + sizeof(back.moves) + 1);
+        assert(binary::readResponse(frame, 0, id, back) == SIZE_MAX);
+        frame[0] = (char) (binary::RESPONSE_HEAD - 4 + solution.length - 1);
+        assert(binary::readResponse(frame, 0, id, back) == SIZE_MAX);
+
+        //a request with a wrong length or key can not be read, an error has no moves
+        frame.clear();
+        binary::writeRequest(request, frame);
+        frame[0] = (char) (binary::REQUEST_SIZE - 3);
+        assert(binary::readRequest(frame, 0, read) == SIZE_MAX);
+        assert(!binary::toFacelets(outOfRange, facelets));
+        binary::toMoves(std::to_string(info::TIME_LIMIT), solution);
+        assert(solution.error == info::TIME_LIMIT && solution.length == 0);
+    }
+
+    //test the parser of the HTTP requests
+    void testParser(){
+        const std::string get = "GET /?c=" + tools::randomCube() + "&m=20 HTTP/1.1\r\nHost: a\r\n\r\n";
+        const std::string post = "POST /solve?p=1 HTTP/1.1\r\nContent-Length: 5\r\nConnection: close\r\n\r\nA\nB\n\n";
+        std::vector<std::string> cubes;
+        parser::request_t request;
+        std::string input, value;
+        size_t used;
+
+        //a request split anywhere is parsed once it is complete
+        for(size_t i = 0; i < get.length(); i++)
+            assert(parser::parse(get.substr(0, i), 0, request) == 0);
+
+        assert(parser::parse(get, 0, request) == get.length() && request.status == 0 && request.method == "GET");
+        assert(request.path == "/" && request.query == get.substr(6, get.find(' ', 4) - 6) && request.keepAlive);
+
+        for(size_t i = post.find("\r\n\r\n") + 4; i < post.length(); i++)
+            assert(parser::parse(post.substr(0, i), 0, request) == 0);
+
+        assert(parser::parse(post, 0, request) == post.length() && request.path == "/solve" && request.query == "p=1");
+        assert(request.body == "A\nB\n\n" && !request.keepAlive);
+
+        //the pipelined requests follow each other, the empty lines between them are skipped
+        input = get + "\r\n" + post + get.substr(0, 10);
+        assert((used = parser::parse(input, 0, request)) == get.length());
+        assert(parser::parse(input, used, request) == post.length() + 2 && request.method == "POST");
+        assert(parser::parse(input, used + post.length() + 2, request) == 0);
+
+        //the old clients send the query without the '?', HTTP/1.0 closes unless it keeps alive
+        assert(parser::parse("GET /c=UUU&m=21 HTTP/1.0\r\n\r\n", 0, request) > 0);
+        assert(request.path == "/" && request.query == "c=UUU&m=21" && !request.keepAlive);
+        assert(parser::parse("GET /r HTTP/1.0\nConnection: Keep-Alive\n\n", 0, request) > 0);
+        assert(request.path == "/r" && request.query.empty() && request.keepAlive);
+
+        //the errors take all the input
+        input = "GET / HTTP/2.0\r\n\r\nGET / HTTP/1.1\r\n\r\n";
+        assert(parser::parse(input, 0, request) == input.length() && request.status == 400);
+        assert(parser::parse("GET / HTTP/1.1\r\nHost\r\n\r\n", 0, request) > 0 && request.status == 400);
+        assert(parser::parse("GET / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n", 0, request) > 0 && request.status == 400);
+        assert(parser::parse("POST /solve HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n", 0, request) > 0 &&
+               request.status == 411);
+        assert(parser::parse("POST /solve HTTP/1.1\r\nContent-Length: " + std::to_string(parser::MAX_BODY + 1) +
+                             "\r\n\r\n", 0, request) > 0 && request.status == 413);
+
+        input = "GET / HTTP/1.1\r\nX: " + std::string(parser::MAX_HEAD, 'x');
+        assert(parser::parse(input.substr(0, parser::MAX_HEAD), 0, request) == 0);
+        assert(parser::parse(input, 0, request) == input.length() && request.status == 431);
+
+        //the parameters are matched by their whole name
+        assert(parser::param("pp=1&p=2&c=", "p", value) && value == "2");
+        assert(parser::param("pp=1&p=2&c=", "c", value) && value.empty());
+        assert(!parser::param("pp=1&p=2&c=", "P", value));
+
+        //the cubes of a batch: a JSON array or one per line
+        assert(parser::readCubes(" [ \"A\" ,\"B\"]\n", cubes) && cubes == std::vector<std::string>({"A", "B"}));
+        assert(parser::readCubes("[]", cubes) && cubes.size() == 2);
+        cubes.clear();
+        assert(parser::readCubes("A\r\n\nB\nC", cubes) && cubes == std::vector<std::string>({"A", "B", "C"}));
+
+        for(const char* body : {"[\"A\",]", "[\"A\"", "[\"A\"] x", "[\"A\" \"B\"]", "[A]"})
+            assert(!parser::readCubes(body, cubes));
+    }
+
+#ifdef __linux__
+    //send a request to the server of the tests, the response is read until the server closes the connection
+    std::string ask(const std::string& request){
+        struct sockaddr_in address{};
+        std::string response;
+        char msg[4096];
+        ssize_t size;
+        const int32_t fd = socket(AF_INET, SOCK_STREAM, 0);
+
+        address.sin_family = AF_INET;
+        address.sin_port = htons(SERVER_PORT);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        assert(fd >= 0 && connect(fd, (struct sockaddr*) &address, sizeof(address)) == 0);
+        assert(send(fd, request.data(), request.length(), MSG_NOSIGNAL) == (ssize_t) request.length());
+
+        while((size = recv(fd, msg, sizeof(msg), 0)) > 0)
+            response.append(msg, (size_t) size);
+
+        close(fd);
+
+        return response;
+    }
+
+    //the body of a chunked response
+    std::string unchunk(const std::string& response){
+        size_t pos = response.find("\r\n\r\n") + 4, size;
+        std::string body;
+        char* end;
+
+        while((size = std::strtoul(response.c_str() + pos, &end, 16)) > 0){
+            pos = response.find("\r\n", pos) + 2;
+            body.append(response, pos, size);
+            pos += size + 2;
+        }
+
+        return body;
+    }
+#endif
+
+    //test the solver server
+    void testServer(){
+#ifdef __linux__
+        const size_t nCubes = QUEUE_PER_THREAD * std::max(1u, std::thread::hardware_concurrency()) + 1;
+        std::vector<bool> solved(nCubes, false);
+        std::string body, line;
+        size_t index;
+        char* end;
+
+        assert(http::init(SERVER_PORT, 16));
+
+        //a batch with more cubes than the queue is served on an idle server
+        for(size_t i = 0; i < nCubes; i++)
+            body += tools::randomCube() + "\n";
+
+        body = ask("POST /solve HTTP/1.1\r\nConnection: close\r\nContent-Length: " + std::to_string(body.length()) +
+                   "\r\n\r\n" + body);
+        assert(body.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+
+        std::istringstream lines(unchunk(body));
+
+        while(std::getline(lines, line)){
+            index = std::strtoul(line.c_str(), &end, 10);
+
+            //one solution for every cube, no error
+            assert(end != line.c_str() && index < nCubes && !solved[index]);
+            assert(std::isupper(end[1]));
+            solved[index] = true;
+        }
+
+        assert(std::find(solved.begin(), solved.end(), false) == solved.end());
+        assert(http::stop());
+#endif
     }
 
 }   }
@@ -29,6 +29,76 @@ namespace min2phase{ namespace tests{
      */
     void testSearch();
 
+    /**
+     * Test if the tables file is written in the portable format and
+     * read back correctly.
+     */
+    void testTableFile();
+
+    /**
+     * Test if the solutions are valid while the phase 1 pruning tables
+     * are computed in background.
+     */
+    void testProgressive();
+
+    /**
+     * Test if every set of tables generates valid and optimal solutions.
+     */
+    void testProfiles();
+
+    /**
+     * Test the rank and unrank of the permutation and combination
+     * coordinates, and the parity of the permutations.
+     */
+    void testCoordinates();
+
+    /**
+     * Test that the key of a state does not depend on the colors and
+     * that different states have different keys.
+     */
+    void testStateKey();
+
+    /**
+     * Test the constraints on the trace of the random cubes on cubes
+     * with a known trace.
+     */
+    void testConstraints();
+
+    /**
+     * Test that the cache gives the solutions of the search for the same
+     * state and parameters, and that it stays in its limit.
+     */
+    void testCache();
+
+    /**
+     * Test the checks of the LTCT cases.
+     */
+    void testLtct();
+
+    /**
+     * Test that the metrics sum the counters of all the threads and that
+     * the histograms count every solve.
+     */
+    void testMetrics();
+
+    /**
+     * Test the frames of the binary protocol and that its keys and moves
+     * give back the same cubes.
+     */
+    void testBinary();
+
+    /**
+     * Test the parser of the HTTP requests: the partial and pipelined
+     * requests, the errors, the parameters and the cubes of a batch.
+     */
+    void testParser();
+
+    /**
+     * Test that the server answers a batch with more cubes than its
+     * queue.
+     */
+    void testServer();
+
 }   }
 
 #endif //MIN2PHASE_TESTS_H
@@ -8,12 +8,16 @@
 #include <min2phase/tools.h>
 #include <memory>
 #include <chrono>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <min2phase/min2phase.h>
 #include <string>
+#include <vector>
+#include "constraints.h"
 #include "coords.h"
+#include "memory.h"
 #include "Search.h"
 #include "tests.h"
 
@@ -43,278 +47,185 @@ namespace min2phase { namespace tools {
      */
     static const int16_t MIN_PROBES_LIMIT = 10240;
 
+    /**
+     * The number of random cube to solve in the huge pages benchmarking.
+     */
+    static const int16_t N_PAGES_BENCH = 2000;
+
+    /**
+     * The number of runs for every type of pages in the huge pages benchmarking.
+     */
+    static const int8_t N_PAGES_RUNS = 3;
+
+    /**
+     * The number of cubes solved with a long probeMin in the profiles benchmarking.
+     */
+    static const int8_t N_PROBE_BENCH = 20;
+
+    /**
+     * The number of cubes solved optimally in the profiles benchmarking.
+     */
+    static const int8_t N_OPT_BENCH = 8;
+
+    /**
+     * The length of the scrambles solved optimally in the profiles benchmarking.
+     */
+    static const int8_t OPT_SCRAMBLE_LENGTH = 12;
+
+    /**
+     * The number of random cubes and coordinates in the coordinates benchmarking.
+     */
+    static const int16_t N_COORD_INPUTS = 4096;
+
+    /**
+     * The number of runs over the inputs in the coordinates benchmarking.
+     */
+    static const int16_t N_COORD_RUNS = 2000;
+
     //set random seed
     void setRandomSeed(uint32_t seed) {
         std::srand(seed);
     }
 
-    bool bufferOnLastTarget(CubieCube cube, char target, char twist) {
-        std::string faces = CubieCube::toFaceCube(cube);
-        std::string clockwise = "EIQGKOS";
-        char firstSticker;
-        char secondSticker;
-        if (twist == 'C') {
-            firstSticker = 'U';
-            secondSticker = 'R';
-        } else if (clockwise.find(twist) != std::string::npos) {
-            firstSticker = 'R';
-            secondSticker = 'F';
-        } else {
-            firstSticker = 'F';
-            secondSticker = 'U';
-        }
-        if (target == 'A') {
-            if (faces[0] == firstSticker && faces[36] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'B') {
-            if (faces[2] == firstSticker && faces[45] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'D') {
-            if (faces[6] == firstSticker && faces[18] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'E') {
-            if (faces[36] == firstSticker && faces[47] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'F') {
-            if (faces[38] == firstSticker && faces[6] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'G') {
-            if (faces[44] == firstSticker && faces[24] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'H') {
-            if (faces[42] == firstSticker && faces[33] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'I') {
-            if (faces[18] == firstSticker && faces[38] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'K') {
-            if (faces[26] == firstSticker && faces[15] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'L') {
-            if (faces[24] == firstSticker && faces[27] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'N') {
-            if (faces[11] == firstSticker && faces[2] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'O') {
-            if (faces[17] == firstSticker && faces[51] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'P') {
-            if (faces[15] == firstSticker && faces[29] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'Q') {
-            if (faces[45] == firstSticker && faces[11] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'R') {
-            if (faces[47] == firstSticker && faces[0] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'S') {
-            if (faces[53] == firstSticker && faces[42] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'T') {
-            if (faces[51] == firstSticker && faces[35] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'U') {
-            if (faces[27] == firstSticker && faces[44] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'V') {
-            if (faces[29] == firstSticker && faces[26] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'W') {
-            if (faces[35] == firstSticker && faces[17] == secondSticker) {
-                return true;
-            } else {
-                return false;
-            }
-        }
-        if (target == 'X') {
-            if (faces[33] == firstSticker && faces[53] == secondSticker) {
-                return true;
-            } else {
-                return false;
+    /**
+     * The facelet of every corner target from 'A' to 'X' (Speffz), -1 for the
+     * stickers of the buffer (URF).
+     */
+    static const int8_t TARGET_FACELET[info::N_CORNER_STICKERS] = {
+            info::U1, info::U3, -1, info::U7, info::L1, info::L3, info::L9, info::L7,
+            info::F1, -1, info::F9, info::F7, -1, info::R3, info::R9, info::R7,
+            info::B1, info::B3, info::B9, info::B7, info::D1, info::D3, info::D9, info::D7
+    };
+
+    /**
+     * The twists of the buffer that bring its R sticker on the target.
+     */
+    static const char CLOCKWISE_TWISTS[] = "EIQGKOS";
+
+    /**
+     * The corner tables of the LTCT checks.
+     */
+    typedef struct ltctTables_s {
+        /**
+         * The position and the index of the facelet in the position of every
+         * target.
+         */
+        int8_t slot[info::N_CORNER_STICKERS];
+        int8_t index[info::N_CORNER_STICKERS];
+
+        /**
+         * The target of the U/D sticker of a corner twisted in its position,
+         * for every position and orientation.
+         */
+        char twist[info::NUMBER_CORNER][info::CORNE_ORI_CASES];
+    }ltctTables_t;
+
+    /**
+     * Build the corner tables of the LTCT checks from the facelets of the corners.
+     *
+     * @return  : the tables.
+     */
+    static constexpr ltctTables_t ltctTables() {
+        ltctTables_t t{};
+        int8_t target = 0, slot = 0, index = 0;
+
+        for (target = 0; target < info::N_CORNER_STICKERS; target++) {
+            for (slot = 0; slot < info::NUMBER_CORNER; slot++) {
+                for (index = 0; index < info::CORNE_ORI_CASES; index++) {
+                    if (info::cornerFacelet[slot][index] == TARGET_FACELET[target]) {
+                        t.slot[target] = slot;
+                        t.index[target] = index;
+                        t.twist[slot][index] = (char) ('A' + target);
+                    }
+                }
             }
         }
 
-        return true;
+        return t;
     }
 
+    /**
+     * The corner tables of the LTCT checks.
+     */
+    static constexpr ltctTables_t LTCT = ltctTables();
+
+    /**
+     * Check if the buffer (URF, corner 0) is on the target with the sticker
+     * of the twist on it: U with no twist ('C'), R with a clockwise twist,
+     * F with the others. Buffer stickers and other chars are always accepted.
+     *
+     * @param cube      : the cube to check.
+     * @param target    : the target (Speffz).
+     * @param twist     : the twist, 'C' for none.
+     * @return          : true if the buffer is on the target.
+     */
+    static bool bufferOnLastTarget(const CubieCube &cube, char target, char twist) {
+        const int8_t t = (int8_t) (target - 'A');
+        int8_t sticker;
+
+        if (t < 0 || t >= info::N_CORNER_STICKERS || TARGET_FACELET[t] < 0)
+            return true;
 
-    int returnSingleTwist(CubieCube cube) {
-        std::string faces = CubieCube::toFaceCube(cube);
-        int numTwists = 0;
+        sticker = twist == 'C' ? 0 : (twist != '\0' && std::strchr(CLOCKWISE_TWISTS, twist) != nullptr ? 1 : 2);
+
+        return cube.corners[LTCT.slot[t]] == (LTCT.index[t] - sticker + info::CORNE_ORI_CASES) % info::CORNE_ORI_CASES
+                                             << info::CORNE_ORI_CASES;
+    }
+
+    /**
+     * Get the twist of the only corner twisted in its position.
+     *
+     * @param cube      : the cube to check.
+     * @return          : the target of the U/D sticker of the twisted corner,
+     *                    'Z' if no corner is twisted, 0 if more than one is
+     *                    or the buffer is in its position.
+     */
+    static int returnSingleTwist(const CubieCube &cube) {
         char singleTwist = 'Z';
-        if (faces[8] == 'U' && faces[9] == 'R') {
-            return 0;
-        } else if (faces[8] == 'R' && faces[9] == 'F') {
-            return 0;
-        } else if (faces[8] == 'F' && faces[9] == 'U') {
+        int8_t i;
+
+        if ((cube.corners[0] & 0x7) == 0)
             return 0;
-        }
-        if (faces[6] == 'F' && faces[18] == 'L') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'F';
-        }
-        if (faces[6] == 'L' && faces[18] == 'U') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'I';
-        }
-        if (faces[0] == 'B' && faces[36] == 'U') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'E';
-        }
-        if (faces[0] == 'L' && faces[36] == 'B') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'R';
-        }
-        if (faces[2] == 'R' && faces[45] == 'U') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'Q';
-        }
-        if (faces[2] == 'B' && faces[45] == 'R') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'N';
-        }
-        if (faces[29] == 'R' && faces[26] == 'D') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'K';
-        }
-        if (faces[29] == 'F' && faces[26] == 'R') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'P';
-        }
-        if (faces[27] == 'F' && faces[44] == 'D') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'G';
-        }
-        if (faces[27] == 'L' && faces[44] == 'F') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'L';
-        }
-        if (faces[33] == 'L' && faces[53] == 'D') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'S';
-        }
-        if (faces[33] == 'B' && faces[53] == 'L') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'H';
-        }
-        if (faces[35] == 'B' && faces[17] == 'D') {
-            if (++numTwists > 1) {
-                return 0;
-            }
-            singleTwist = 'O';
-        }
-        if (faces[35] == 'R' && faces[17] == 'B') {
-            if (++numTwists > 1) {
-                return 0;
+
+        for (i = 1; i < info::NUMBER_CORNER; i++) {
+            if ((cube.corners[i] & 0x7) == i && cube.corners[i] >> info::CORNE_ORI_CASES != 0) {
+                if (singleTwist != 'Z')
+                    return 0;
+
+                singleTwist = LTCT.twist[i][cube.corners[i] >> info::CORNE_ORI_CASES];
             }
-            singleTwist = 'T';
         }
 
-
         return singleTwist;
     }
 
+    /**
+     * Check the rest of the LTCT trace: the corners out of their position
+     * are a single cycle through the buffer (URF, corner 0), so the trace
+     * has no cycle break, and no corner is twisted without a twist ('C').
+     * Buffer stickers and other chars are always accepted.
+     *
+     * @param cube      : the cube to check.
+     * @param target    : the target (Speffz).
+     * @param twist     : the twist, 'C' for none.
+     * @return          : true if the trace has no break and no extra twist.
+     */
+    static bool ltctTrace(const CubieCube &cube, char target, char twist) {
+        const int8_t t = (int8_t) (target - 'A');
+        int8_t i, length = 0, moved = 0;
+
+        if (t < 0 || t >= info::N_CORNER_STICKERS || TARGET_FACELET[t] < 0)
+            return true;
+
+        for (i = cube.corners[0] & 0x7; i != 0; i = cube.corners[i] & 0x7)
+            length++;
+
+        for (i = 1; i < info::NUMBER_CORNER; i++)
+            moved += (cube.corners[i] & 0x7) != i;
+
+        return length == moved && (twist != 'C' || returnSingleTwist(cube) == 'Z');
+    }
+
     //get random cube
     std::string randomCube(char target, char twist) {
         if (!coords::isInit())
@@ -326,41 +237,98 @@ namespace min2phase { namespace tools {
         int16_t cornerOri, edgeOri;
         uint16_t cornerPerm;
         int32_t edgePerm;
-        bool been = false;
         int count = 0;
         if (twist == 'C') {
-            while (!bufferOnLastTarget(cube, target, 'C')) {
+            do {
                 parity = 0;
                 while (parity == 0) {
-                    cornerPerm = std::rand() % (info::N_PERM + 1);
-                    cornerOri = std::rand() % (info::N_TWIST + 1);
+                    cornerPerm = std::rand() % info::N_PERM;
+                    cornerOri = std::rand() % info::N_TWIST;
                     parity = CubieCube::getNParity(cornerPerm, info::NUMBER_CORNER);
                     count += 1;
                 }
                 cube.setCoords(cornerPerm, cornerOri, 0, 0);
-            }
+            } while (!bufferOnLastTarget(cube, target, 'C') || !ltctTrace(cube, target, 'C') ||
+                     !constraints::acceptCorners(cube, cornerPerm));
         } else {
 
-            while (!bufferOnLastTarget(cube, target, twist) || returnSingleTwist(cube) != twist) {
+            do {
                 parity = 0;
                 while (parity == 0) {
-                    cornerPerm = std::rand() % (info::N_PERM + 1);
-                    cornerOri = std::rand() % (info::N_TWIST + 1);
+                    cornerPerm = std::rand() % info::N_PERM;
+                    cornerOri = std::rand() % info::N_TWIST;
                     parity = CubieCube::getNParity(cornerPerm, info::NUMBER_CORNER);
                     count += 1;
                 }
                 cube.setCoords(cornerPerm, cornerOri, 0, 0);
-            }
+            } while (!bufferOnLastTarget(cube, target, twist) || returnSingleTwist(cube) != twist ||
+                     !ltctTrace(cube, target, twist) || !constraints::acceptCorners(cube, cornerPerm));
         }
-        edgeOri = std::rand() % (info::N_FLIP + 1);
+
+        //the edges are drawn again until they satisfy the constraints
         do {
-            edgePerm = std::rand() % (info::FULL_E_PERM + 1);
-        } while (CubieCube::getNParity(edgePerm, info::NUMBER_EDGES) != parity);
+            edgeOri = std::rand() % info::N_FLIP;
+            do {
+                edgePerm = std::rand() % info::FULL_E_PERM;
+            } while (CubieCube::getNParity(edgePerm, info::NUMBER_EDGES) != parity);
+
+            cube.setCoords(cornerPerm, cornerOri, edgePerm, edgeOri);
+        } while (!constraints::acceptEdges(cube));
 
-        cube.setCoords(cornerPerm, cornerOri, edgePerm, edgeOri);
         return CubieCube::toFaceCube(cube);
     }
 
+    //the target is not on the buffer and the twisted corner is not the one of the target
+    bool validLtct(char target, char twist) {
+        const int8_t t = (int8_t) (target - 'A');
+        int8_t i, j;
+
+        if (t < 0 || t >= info::N_CORNER_STICKERS || TARGET_FACELET[t] < 0)
+            return false;
+
+        if (twist == 'C')
+            return true;
+
+        for (i = 1; i < info::NUMBER_CORNER; i++) {
+            for (j = 1; j < info::CORNE_ORI_CASES; j++) {
+                if (LTCT.twist[i][j] == twist)
+                    return LTCT.slot[t] != i;
+            }
+        }
+
+        return false;
+    }
+
+    //check the LTCT trace of a cube, the same checks of the random cubes
+    bool isLtct(const std::string& facelets, char target, char twist) {
+        CubieCube cube;
+
+        if (!validLtct(target, twist) || CubieCube::fromFacelets(facelets, cube) != info::NO_ERROR ||
+            CubieCube::getNParity(cube.getCPerm(), info::NUMBER_CORNER) == 0)
+            return false;
+
+        if (twist == 'C')
+            return bufferOnLastTarget(cube, target, 'C') && ltctTrace(cube, target, 'C');
+
+        return bufferOnLastTarget(cube, target, twist) && returnSingleTwist(cube) == twist &&
+               ltctTrace(cube, target, twist);
+    }
+
+    //add a constraint to the random cubes
+    bool addConstraint(const std::string& rule) {
+        return constraints::add(rule);
+    }
+
+    //remove the constraints
+    void clearConstraints() {
+        constraints::clear();
+    }
+
+    //acceptance of the constraints
+    std::string constraintsReport() {
+        return constraints::report();
+    }
+
     //convert moves to scrambled cube
     std::string fromScramble(const int8_t scramble[], uint8_t length) {
         uint8_t i;
@@ -560,6 +528,238 @@ namespace min2phase { namespace tools {
         }
     }
 
+    /**
+     * Benchmark the solve throughput.
+     *
+     * @param cubes     : the cubes to solve.
+     * @return          : the number of cubes solved for second.
+     */
+    static double benchThroughput(const std::vector<std::string>& cubes) {
+        using namespace std::chrono;
+
+        time_point<high_resolution_clock> begin, end;
+        uint8_t usedMoves;
+
+        begin = high_resolution_clock::now();
+
+        for (const std::string& cube : cubes)
+            solve(cube, 21, 1000000, 0, 0, &usedMoves);
+
+        end = high_resolution_clock::now();
+
+        return cubes.size() / duration_cast<duration<double>>(end - begin).count();
+    }
+
+    /**
+     * Print the solve throughput with normal pages and huge pages.
+     */
+    void benchmarkHugePages() {
+        using namespace std;
+        const char* pages[] = {"normal", "transparent", "hugetlbfs"};
+        vector<string> cubes;
+        double best[2] = {0, 0};
+        memory::Backing backing = memory::SMALL_PAGES;
+        int8_t i, huge;
+
+        cout << "CPU model: " << getCPUname() << endl;
+
+        if (!coords::isInit())
+            init();
+
+        min2phase::tools::setRandomSeed(time(nullptr));
+
+        for (int16_t n = 0; n < N_PAGES_BENCH; n++)
+            cubes.push_back(randomCube());
+
+        for (i = 0; i < N_PAGES_RUNS; i++) {
+            for (huge = 0; huge < 2; huge++) {
+                memory::hugePages(huge == 1);
+
+                if (huge == 1)
+                    backing = memory::backing();
+
+                best[huge] = std::max(best[huge], benchThroughput(cubes));
+            }
+        }
+
+        memory::hugePages(false);
+
+        cout << "\n|    Pages    |  Solves/s  |\n|:-----------:|:----------:|\n";
+        cout << "|" << setw(12) << pages[memory::SMALL_PAGES] << " |";
+        cout << fixed << setprecision(1) << setw(10) << best[0] << "  |\n";
+        cout << "|" << setw(12) << pages[backing] << " |";
+        cout << fixed << setprecision(1) << setw(10) << best[1] << "  |\n";
+    }
+
+    /**
+     * Get the resident memory of the process.
+     *
+     * @return          : the resident memory in kB, 0 if it is not available.
+     */
+    static long residentMemory() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+
+        while (std::getline(status, line))
+            if (line.compare(0, 6, "VmRSS:") == 0)
+                return std::stol(line.substr(6));
+
+        return 0;
+    }
+
+    /**
+     * Generate a random scramble without two moves on the same face in a row.
+     *
+     * @param length    : the number of moves.
+     * @return          : the scrambled cube.
+     */
+    static std::string randomScramble(uint8_t length) {
+        int8_t scramble[OPT_SCRAMBLE_LENGTH];
+        uint8_t i;
+
+        for (i = 0; i < length; i++) {
+            do {
+                scramble[i] = std::rand() % info::N_MOVES;
+            } while (i > 0 && scramble[i] / 3 == scramble[i - 1] / 3);
+        }
+
+        return fromScramble(scramble, length);
+    }
+
+    /**
+     * Benchmark the solve time.
+     *
+     * @param cubes     : the cubes to solve.
+     * @param probeMin  : min probes to use for the search.
+     * @param verbose   : the flags of the search.
+     * @return          : the average time for a cube in ms.
+     */
+    static double benchAverage(const std::vector<std::string>& cubes, int32_t probeMin, int8_t verbose) {
+        using namespace std::chrono;
+
+        time_point<high_resolution_clock> begin, end;
+
+        begin = high_resolution_clock::now();
+
+        for (const std::string& cube : cubes)
+            solve(cube, 31, 1000000000, probeMin, verbose, nullptr);
+
+        end = high_resolution_clock::now();
+
+        return duration_cast<duration<double, std::milli>>(end - begin).count() / cubes.size();
+    }
+
+    /**
+     * Print the memory and speed of every set of tables.
+     */
+    void benchmarkProfiles() {
+        using namespace std;
+        using namespace std::chrono;
+        const char* names[] = {"minimal", "standard", "large"};
+        const Profile profiles[] = {MINIMAL_TABLES, STANDARD_TABLES, LARGE_TABLES};
+        vector<string> cubes, probeCubes, optCubes;
+        time_point<high_resolution_clock> begin, end;
+        int16_t n;
+
+        cout << "CPU model: " << getCPUname() << endl;
+
+        init(MINIMAL_TABLES);
+        min2phase::tools::setRandomSeed(time(nullptr));
+
+        for (n = 0; n < N_PAGES_BENCH; n++)
+            cubes.push_back(randomCube());
+
+        for (n = 0; n < N_PROBE_BENCH; n++)
+            probeCubes.push_back(randomCube());
+
+        for (n = 0; n < N_OPT_BENCH; n++)
+            optCubes.push_back(randomScramble(OPT_SCRAMBLE_LENGTH));
+
+        cout << "\n| Profile  |   Init   |    RSS    | Solves/s | probeMin 1000 | Optimal, " << (int32_t) OPT_SCRAMBLE_LENGTH << " moves |\n";
+        cout << "|:--------:|:--------:|:---------:|:--------:|:-------------:|:-----------------:|\n";
+
+        for (n = 0; n < 3; n++) {
+            begin = high_resolution_clock::now();
+            init(profiles[n]);
+            end = high_resolution_clock::now();
+
+            cout << "|" << setw(9) << names[n] << " |";
+            cout << setw(6) << duration_cast<milliseconds>(end - begin).count() << " ms |";
+            cout << setw(7) << residentMemory() << " kB |";
+            cout << fixed << setprecision(1) << setw(9) << benchThroughput(cubes) << " |";
+            cout << fixed << setprecision(1) << setw(11) << benchAverage(probeCubes, 1000, 0) << " ms |";
+            cout << fixed << setprecision(1) << setw(15) << benchAverage(optCubes, 0, OPTIMAL_SOLUTION) << " ms |\n";
+        }
+    }
+
+    /**
+     * Benchmark a coordinate kernel.
+     *
+     * @param inputs    : the number of inputs, the kernel is called on every one.
+     * @param kernel    : the kernel, it returns a value that depends on the result.
+     * @return          : the nanoseconds for call.
+     */
+    template<typename F>
+    static double benchKernel(int16_t inputs, F kernel) {
+        using namespace std::chrono;
+
+        time_point<high_resolution_clock> begin, end;
+        volatile int32_t sink;
+        int32_t check = 0;
+
+        begin = high_resolution_clock::now();
+
+        for (int16_t run = 0; run < N_COORD_RUNS; run++)
+            for (int16_t i = 0; i < inputs; i++)
+                check += kernel(i);
+
+        end = high_resolution_clock::now();
+        sink = check;
+        (void) sink;
+
+        return duration<double, std::nano>(end - begin).count() / ((double) inputs * N_COORD_RUNS);
+    }
+
+    /**
+     * Print the nanoseconds of the rank and unrank of every coordinate.
+     */
+    void benchmarkCoordinates() {
+        using namespace std;
+        vector<CubieCube> cubes(N_COORD_INPUTS);
+        vector<int32_t> perms(N_COORD_INPUTS), mPerms(N_COORD_INPUTS), slices(N_COORD_INPUTS), parities(N_COORD_INPUTS);
+        CubieCube cube;
+        int16_t i;
+
+        cout << "CPU model: " << getCPUname() << endl;
+
+        info::init();
+        min2phase::tools::setRandomSeed(time(nullptr));
+
+        for (i = 0; i < N_COORD_INPUTS; i++) {
+            perms[i] = std::rand() % info::N_PERM;
+            mPerms[i] = std::rand() % info::N_MPERM;
+            slices[i] = std::rand() % info::N_SLICE;
+            parities[i] = std::rand();
+            cubes[i].setCoords((uint16_t) perms[i], 0, parities[i] % 479001600, 0);
+        }
+
+        cout << "\n|   Kernel   | Elements | ns/call |\n|:----------:|:--------:|:-------:|\n";
+        cout << "| setCPerm   |     8    |" << fixed << setprecision(2) << setw(7) << benchKernel(N_COORD_INPUTS,
+                [&](int16_t i) { cube.setCPerm((uint16_t) perms[i]); return cube.corners[i & 7]; }) << "  |\n";
+        cout << "| getCPerm   |     8    |" << setw(7) << benchKernel(N_COORD_INPUTS,
+                [&](int16_t i) { return cubes[i].getCPerm(); }) << "  |\n";
+        cout << "| setMPerm   |    12    |" << setw(7) << benchKernel(N_COORD_INPUTS,
+                [&](int16_t i) { cube.setMPerm((int8_t) mPerms[i]); return cube.edges[i % info::NUMBER_EDGES]; }) << "  |\n";
+        cout << "| getMPerm   |    12    |" << setw(7) << benchKernel(N_COORD_INPUTS,
+                [&](int16_t i) { return cubes[i].getMPerm(); }) << "  |\n";
+        cout << "| setUDSlice |    12    |" << setw(7) << benchKernel(N_COORD_INPUTS,
+                [&](int16_t i) { cube.setUDSlice((int16_t) slices[i]); return cube.edges[i % info::NUMBER_EDGES]; }) << "  |\n";
+        cout << "| getUDSlice |    12    |" << setw(7) << benchKernel(N_COORD_INPUTS,
+                [&](int16_t i) { return cubes[i].getUDSlice(); }) << "  |\n";
+        cout << "| getNParity |    12    |" << setw(7) << benchKernel(N_COORD_INPUTS,
+                [&](int16_t i) { return CubieCube::getNParity((uint32_t) parities[i] % 479001600, info::NUMBER_EDGES); }) << "  |\n";
+    }
+
     //check integrity
     int8_t verify(const std::string& facelets){
         Search s;
@@ -567,6 +767,23 @@ namespace min2phase { namespace tools {
         return s.verify(facelets);
     }
 
+    //key of the state, no tables are needed
+    bool stateKey(const std::string& facelets, uint64_t key[2]) {
+        CubieCube cube;
+
+        if (CubieCube::fromFacelets(facelets, cube) != info::NO_ERROR)
+            return false;
+
+        cube.getKey(key);
+
+        return true;
+    }
+
+    //hash of the key
+    uint64_t stateHash(const uint64_t key[2]) {
+        return CubieCube::hashKey(key);
+    }
+
     //tests
     void testAlgorithm(){
         min2phase::init();
@@ -574,5 +791,17 @@ namespace min2phase { namespace tools {
         tests::testInput();
         tests::testSearchError();
         tests::testSearch();
+        tests::testTableFile();
+        tests::testProgressive();
+        tests::testProfiles();
+        tests::testCoordinates();
+        tests::testStateKey();
+        tests::testConstraints();
+        tests::testCache();
+        tests::testLtct();
+        tests::testMetrics();
+        tests::testBinary();
+        tests::testParser();
+        tests::testServer();
     }
 } }
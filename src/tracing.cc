@@ -1,85 +1,205 @@
 #include "../include/tracing.h"
-#include <iostream>
 
-// Traces the corners from UFR and sets the parity accordingly
-bool Tracing::verify_ltct(Cube& cube, char target, char twist) {
-    std::array<unsigned short, 54> state = cube.get_state();
-    int final_target = target - 'A';
-    int corner_twist = twist - 'A';
-    /* std::cout << corner_twist << std::endl; */
-    static constexpr size_t BUFFER = 2; // UFR
-    // Equivalence relation: 0=4=17, 1=16=13, 2=9=12, 3=5=8, 6=11=20, 7=18=23, 10=15=21, 14=19=22
-    static constexpr std::array<unsigned short, 24> target_to_piece_lookup = {
-        0, 1, 2, 3, 0, 3, 4, 7, 3, 2, 5, 4, 2, 1, 6, 5, 1, 0, 7, 6, 4, 5, 6, 7
-    };
-    static constexpr std::array<int, 24> target_to_UD_lookup = {
-        0, 1, 2, 3, 0, 3, 20, 23, 3, 2, 21, 20, 2, 1, 22, 21, 1, 0, 23, 22
+constexpr int Tracing::CORNER_BUFFER;
+constexpr int Tracing::EDGE_BUFFER;
+
+namespace {
+    // Number of corner stickers, the edge stickers follow
+    constexpr int N_CORNER_STICKERS = 24;
+
+    // Stickers of every corner position, the U/D one first and then clockwise
+    constexpr unsigned char CORNER_SLOTS[8][3] = {
+        {0, 4, 17}, {1, 16, 13}, {2, 12, 9}, {3, 8, 5},
+        {20, 6, 11}, {21, 10, 15}, {22, 14, 19}, {23, 18, 7}
     };
-        
-    static constexpr std::array<unsigned short, 24> twist_lookup = {
-        0, 0, 0, 0, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 0, 0, 0, 0
+
+    // Stickers of every edge position, the U/D (F/B for the E slice) one first
+    constexpr unsigned char EDGE_SLOTS[12][2] = {
+        {24, 40}, {25, 36}, {26, 32}, {27, 28}, {33, 39}, {35, 29},
+        {43, 37}, {41, 31}, {44, 34}, {45, 38}, {46, 42}, {47, 30}
     };
-    static constexpr std::array<unsigned short, 7> corners = {
-        0, 1, 3, 20, 21, 22, 23
+
+    // Piece and index in the piece of every sticker, piece << 2 | index
+    struct StickerTable {
+        unsigned char piece[N_CORNER_STICKERS + 24];
     };
 
-    unsigned short number_of_twists = 0;
-    unsigned short solved = 0;
-    if (corner_twist == 2) {
-        for (unsigned short corner : corners) {
-            if (target_to_piece_lookup[state[corner]] == target_to_piece_lookup[corner]) {
-                unsigned short twist_direction = twist_lookup[state[corner]];
-                if (twist_direction == 0) {
-                    ++solved;
-                } else {
-                    return false;
+    // Inverts the slots of the positions
+    constexpr StickerTable make_sticker_table() {
+        StickerTable table{};
+
+        for (int i = 0; i < 8; i++) {
+            for (int j = 0; j < 3; j++) {
+                table.piece[CORNER_SLOTS[i][j]] = (unsigned char) (i << 2 | j);
+            }
+        }
+        for (int i = 0; i < 12; i++) {
+            for (int j = 0; j < 2; j++) {
+                table.piece[EDGE_SLOTS[i][j]] = (unsigned char) (i << 2 | j);
+            }
+        }
+
+        return table;
+    }
+
+    constexpr StickerTable STICKERS = make_sticker_table();
+
+    // Reads one kind of pieces from the stickers: the piece at the first sticker
+    // of the position, and where its first sticker is
+    template<int N, int O, typename T>
+    void read_pieces(const unsigned char (&slots)[N][O], const T* state,
+                     unsigned char* perm, unsigned char* ori) {
+        unsigned char sticker;
+
+        for (int i = 0; i < N; i++) {
+            sticker = STICKERS.piece[state[slots[i][0]]];
+            perm[i] = sticker >> 2;
+            ori[i] = (unsigned char) ((O - (sticker & 3)) % O);
+        }
+    }
+
+    // Traces one kind of pieces on a copy of the permutation: every target is
+    // a swap of the buffer with the place of the sticker it holds, a solved
+    // buffer breaks into the first unsolved piece
+    template<int N, int O>
+    void trace_pieces(const unsigned char (&slots)[N][O], const unsigned char* perm, const unsigned char* ori,
+                      int buffer_sticker, unsigned char* targets, unsigned char& n_targets,
+                      unsigned char* wrong, unsigned char& n_wrong, unsigned char& cycles, unsigned char& breaks) {
+        const int buffer = STICKERS.piece[buffer_sticker] >> 2;
+        const int side = STICKERS.piece[buffer_sticker] & 3;
+        unsigned char p[N], o[N];
+        bool visited[N] = {};
+        int held, held_ori, piece, piece_ori, index, place, slot, i, j, unsolved = 0;
+
+        n_targets = n_wrong = cycles = breaks = 0;
+
+        for (i = 0; i < N; i++) {
+            p[i] = perm[i];
+            o[i] = ori[i];
+        }
+
+        for (i = 0; i < N; i++) {
+            if (!visited[i] && p[i] != i) {
+                cycles++;
+                for (j = i; !visited[j]; j = p[j]) {
+                    visited[j] = true;
                 }
             }
         }
-    } else {
-        for (unsigned short corner : corners) {
-            if (target_to_piece_lookup[state[corner]] == target_to_piece_lookup[corner]) {
-                unsigned short twist_direction = twist_lookup[state[corner]];
-                if (twist_direction == 0) {
-                    ++solved;
-                } else {
-                    ++solved;
-                    if (++number_of_twists > 1) {
-                        return false;
-                    }
+
+        //the piece at the buffer is kept out of the arrays until the end
+        held = p[buffer];
+        held_ori = o[buffer];
+
+        while (true) {
+            index = side < held_ori ? side + O - held_ori : side - held_ori;
+
+            if (held == buffer) {
+                //the solved pieces are not moved again, the search goes on from the last break
+                while (unsolved < N && (unsolved == buffer || p[unsolved] == unsolved)) {
+                    unsolved++;
+                }
+                if (unsolved == N) {
+                    break;
                 }
+                place = unsolved;
+                slot = 0;
+                breaks++;
+            } else {
+                place = held;
+                slot = index;
+            }
+
+            targets[n_targets++] = slots[place][slot];
+
+            piece = p[place];
+            piece_ori = o[place];
+            p[place] = (unsigned char) held;
+            o[place] = (unsigned char) (slot < index ? slot + O - index : slot - index);
+            held = piece;
+            held_ori = (side + piece_ori + O - slot) % O;
+        }
+
+        p[buffer] = (unsigned char) held;
+        o[buffer] = (unsigned char) held_ori;
+
+        for (i = 0; i < N; i++) {
+            if (i != buffer && o[i] != 0) {
+                wrong[n_wrong++] = slots[i][o[i]];
             }
         }
     }
-    size_t current_target = BUFFER;
-    size_t last_target = BUFFER;
-    std::vector<unsigned short> targets;
-    unsigned short next_target = state[current_target];
-    while (true) {
-        if (target_to_piece_lookup[next_target] == target_to_piece_lookup[BUFFER]) {
-            if (solved != 8) {
-                /* std::cout << solved << std::endl; */
-                /* for (const auto& target : targets) { */
-                /*     std::cout << target << " "; */
-                /* } */
-                /* std::cout << std::endl; */
-                return false;
-            } else {
-                if (last_target == final_target) {
-                    return true;
-                }
+
+    // Rejects the cubes with too many twisted corners, then traces the corners
+    // from UFR: they must be one cycle ending on the target. n_targets is the
+    // number of corner targets, -1 for the cubes rejected before the trace
+    bool check_ltct(const Cubies& cubies, char target, char twist, int& n_targets) {
+        const int max_twisted = twist - 'A' == 2 ? 0 : 1;
+        Trace result;
+        int twisted = 0;
+
+        n_targets = -1;
+
+        //most cubes have too many twisted corners, they are rejected before the trace
+        for (int i = 0; i < 8; i++) {
+            if (i != Tracing::CORNER_BUFFER && cubies.cp[i] == i && cubies.co[i] != 0 && ++twisted > max_twisted) {
                 return false;
             }
-        } else {
-            next_target = state[current_target];
-            last_target = current_target;
-            ++solved;
-            if (target_to_piece_lookup[next_target] != BUFFER) {
-                targets.push_back(next_target);
-            }
         }
-        current_target = next_target;
+
+        trace_pieces(CORNER_SLOTS, cubies.cp, cubies.co, Tracing::CORNER_BUFFER, result.corner_targets,
+                     result.n_corner_targets, result.twisted_corners, result.n_twisted_corners,
+                     result.corner_cycles, result.corner_breaks);
+        n_targets = result.n_corner_targets;
+
+        if (result.n_corner_targets == 0 || result.corner_breaks != 0) {
+            return false;
+        }
+
+        return result.corner_targets[result.n_corner_targets - 1] == target - 'A';
     }
-    return true;
 }
 
+// Reads the piece at the first sticker of every position
+void Tracing::to_cubies(const Cube& cube, Cubies& cubies) {
+    read_pieces(CORNER_SLOTS, cube.state.data(), cubies.cp, cubies.co);
+    read_pieces(EDGE_SLOTS, cube.state.data(), cubies.ep, cubies.eo);
+}
+
+// Same as above on one byte per sticker
+void Tracing::to_cubies(const unsigned char* stickers, Cubies& cubies) {
+    read_pieces(CORNER_SLOTS, stickers, cubies.cp, cubies.co);
+    read_pieces(EDGE_SLOTS, stickers, cubies.ep, cubies.eo);
+}
+
+// Traces the corners and then the edges
+void Tracing::trace(const Cubies& cubies, Trace& trace, int corner_buffer, int edge_buffer) {
+    trace_pieces(CORNER_SLOTS, cubies.cp, cubies.co, corner_buffer, trace.corner_targets, trace.n_corner_targets,
+                 trace.twisted_corners, trace.n_twisted_corners, trace.corner_cycles, trace.corner_breaks);
+    trace_pieces(EDGE_SLOTS, cubies.ep, cubies.eo, edge_buffer, trace.edge_targets, trace.n_edge_targets,
+                 trace.flipped_edges, trace.n_flipped_edges, trace.edge_cycles, trace.edge_breaks);
+    trace.parity = (trace.n_corner_targets & 1) != 0;
+}
+
+// The corners from UFR must be one cycle ending on the target, with no twist
+// ('C') or at most one twisted corner
+bool Tracing::verify_ltct(Cube& cube, char target, char twist) {
+    Cubies cubies;
+    int n_targets;
+    bool verdict;
+
+    read_pieces(CORNER_SLOTS, cube.state.data(), cubies.cp, cubies.co);
+    verdict = check_ltct(cubies, target, twist, n_targets);
+    if (n_targets >= 0) {
+        cube.set_parity(n_targets);
+    }
+
+    return verdict;
+}
+
+// Same check on cubies read before
+bool Tracing::verify_ltct(const Cubies& cubies, char target, char twist) {
+    int n_targets;
+
+    return check_ltct(cubies, target, twist, n_targets);
+}